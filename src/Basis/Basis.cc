@@ -0,0 +1,210 @@
+#include "Basis.h"
+#include "../Utils/Utils.h"
+#include "../Log/Log.h"
+
+/*******************************************************************************/
+// Custom/only constructor
+/*******************************************************************************/
+Basis::Basis(const Environment &env) : sector(env)
+{
+  // Only the many-body basis is limited by the width of the elements, the single
+  // particle evolution (FreeEvo) is not
+  if(sector.bits() > STATE_MAX_SITES){
+    if(env.mpirank == 0) std::cerr << "The number of bits per element exceeds " << STATE_MAX_SITES 
+      << ", recompile with a larger STATE_WORDS" << std::endl;
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+
+  l_ = env.l;
+  n_ = env.n;
+  basis_size = env.basis_size();
+  if(env.nnz_balance) env.nnz_distribution(basis_size, nlocal, start, end);
+  else env.distribution(basis_size, nlocal, start, end);
+
+  basis_local = nlocal;
+  basis_start = start;
+  if(env.lookup_policy == Environment::LOOKUP_NODE && env.node_rank == 0){
+    basis_local = basis_size;
+    basis_start = 0;
+  }
+  fill_start_ = basis_start;
+  fill_local_ = basis_local;
+  node_comm_ = env.node_comm;
+  window_ = MPI_WIN_NULL;
+
+  if(env.lookup_policy != Environment::LOOKUP_WINDOW){
+    int_basis = new State[basis_local];
+    return;
+  }
+
+  // A single copy of the basis per node, allocated by its first process. The others
+  // map it into their address space and every process computes an equal part
+  basis_local = basis_size;
+  basis_start = 0;
+  fill_local_ = basis_size / env.node_size;
+  PetscInt rest = basis_size % env.node_size;
+  if(rest && (env.node_rank < rest)) fill_local_++;
+  fill_start_ = env.node_rank * fill_local_;
+  if(rest && (env.node_rank >= rest)) fill_start_ += rest;
+
+  MPI_Aint bytes = (env.node_rank == 0) ? basis_size * sizeof(State) : 0;
+  MPI_Win_allocate_shared(bytes, sizeof(State), MPI_INFO_NULL, node_comm_, &int_basis, &window_);
+  int disp_unit;
+  MPI_Win_shared_query(window_, 0, &bytes, &disp_unit, &int_basis);
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, window_);
+}
+
+/*******************************************************************************/
+// Copy constructor
+/*******************************************************************************/
+Basis::Basis(const Basis &rhs) : sector(rhs.sector)
+{
+  std::cout << "Copy constructor (basis) has been called!" << std::endl;
+
+  l_ = rhs.l_;
+  n_ = rhs.n_;
+  basis_size = rhs.basis_size;
+  nlocal = rhs.nlocal;
+  start = rhs.start;
+  end = rhs.end;
+  basis_local = rhs.basis_local;
+  basis_start = rhs.basis_start;
+  fill_start_ = basis_start;
+  fill_local_ = basis_local;
+  node_comm_ = rhs.node_comm_;
+  window_ = MPI_WIN_NULL;
+
+  // A copy of a shared window is a private array with the same elements
+  int_basis = new State[basis_local];
+  for(LLInt i = 0; i < basis_local; ++i)
+    int_basis[i] = rhs.int_basis[i];
+}
+
+/*******************************************************************************/
+// Assignment operator
+/*******************************************************************************/
+Basis &Basis::operator=(const Basis &rhs)
+{
+  std::cout << "Assignment operator (basis) has been called!" << std::endl;
+
+  destroy_int_basis_();
+  l_ = rhs.l_;
+  n_ = rhs.n_;
+  sector = rhs.sector;
+  basis_size = rhs.basis_size;
+  nlocal = rhs.nlocal;
+  start = rhs.start;
+  end = rhs.end;
+  basis_local = rhs.basis_local;
+  basis_start = rhs.basis_start;
+  fill_start_ = basis_start;
+  fill_local_ = basis_local;
+  node_comm_ = rhs.node_comm_;
+  window_ = MPI_WIN_NULL;
+
+  int_basis = new State[basis_local];
+  for(LLInt i = 0; i < basis_local; ++i)
+    int_basis[i] = rhs.int_basis[i];
+
+  return *this;
+}
+
+Basis::~Basis()
+{
+  destroy_int_basis_();
+}
+
+/*******************************************************************************/
+// Collective on the node if the elements are in a shared window
+/*******************************************************************************/
+void Basis::destroy_int_basis_()
+{
+  if(window_ == MPI_WIN_NULL){
+    delete [] int_basis;
+    return;
+  }
+
+  MPI_Win_unlock_all(window_);
+  MPI_Win_free(&window_);
+}
+
+/*******************************************************************************/
+// Helper function.
+/*******************************************************************************/
+LLInt Basis::factorial_(LLInt n)
+{
+  return (n == 1 || n == 0) ? 1 : factorial_(n - 1) * n;
+}
+
+/*******************************************************************************/
+// Returns the integer representation of the first element computed locally.
+// Sector::unrank() gives it directly from the global index, instead of
+// applying fill_start_ permutations to the first element.
+/*******************************************************************************/
+State Basis::first_int_()
+{
+  return sector.unrank(fill_start_);
+}
+
+/*******************************************************************************/
+// Computes next bit permutation lexicographically, so for a given value of
+// smallest ineteger, computes the next lowest integer that has a different 
+// bit combination. Since we know the number of combinations possible, this 
+// returns an array which contains all possible combinations represented as
+// integer values.
+/*******************************************************************************/
+void Basis::construct_int_basis()
+{
+  Log::stage_push(Log::STAGE_BASIS);
+  Log::event_begin(Log::EVENT_BASIS);
+
+  if(fill_local_ > 0){
+    State *part = int_basis + (fill_start_ - basis_start);
+    State first = first_int_();
+
+    part[0] = first;
+
+    for(LLInt i = 1; i < fill_local_; ++i){
+      first = sector.next(first);
+      part[i] = first;
+    }
+  }
+
+  // The parts written by the other processes of the node become visible
+  if(window_ != MPI_WIN_NULL){
+    MPI_Win_sync(window_);
+    MPI_Barrier(node_comm_);
+    MPI_Win_sync(window_);
+  }
+
+  Log::event_end(Log::EVENT_BASIS);
+  Log::stage_pop();
+}
+
+/*******************************************************************************/
+// Print to std out
+/*******************************************************************************/
+void Basis::print_basis(const Environment &env, 
+                        bool bits)
+{
+  std::cout << "Global rank: " << env.mpirank << std::endl;
+  for(LLInt i = 0; i < basis_local; ++i){
+    if(bits){
+      std::cout << Utils::state_to_binary(int_basis[i], sector.bits()) << std::endl;
+    }
+    else
+      std::cout << int_basis[i] << std::endl;
+  }
+}
+
+/*******************************************************************************/
+// Given an integer represented basis we know compute the basis in binary no
+// tation, boost library provides best results on the long run.
+// See Pieterse, et al. (2010) for a reference
+/*******************************************************************************/
+void Basis::construct_bit_basis(boost::dynamic_bitset<> *bit_basis)
+{
+  for(LLInt i = 0; i < basis_local; ++i){
+    bit_basis[i] = Utils::state_to_binary(int_basis[i], sector.bits());
+  }
+}
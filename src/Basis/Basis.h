@@ -1,15 +1,16 @@
-/** @addtogroup NodeComm
+/** @addtogroup Core
  * @{
  */
 /**
- * \class BasisNC
- * \ingroup NodeComm
+ * \class Basis
+ * \ingroup Core
  * \brief A computational representation of the Hilbert space basis.
  *        Refer to Section 3 of the manuscript in /docs.
  *
- * For the particular case of the Node communication approach, the basis elements are 
- * fully distributed among all available processing elements, with the exception of the first process
- * of each computational node; which allocates, computes and holds all the elements of the basis. 
+ * Every process holds the elements of its own rows. Depending on the lookup policy (see
+ * Environment::LookupPolicy), the first process of each node holds all the elements of the basis
+ * instead (node), or all the processes of a node share a single copy of the full basis in an
+ * MPI-3 shared memory window, each of them computing one part (window).
  */
 #ifndef __BASIS_H
 #define __BASIS_H
@@ -18,8 +19,10 @@
 #include <cmath>
 
 #include "../Environment/Environment.h"
+#include "State.h"
+#include "Sector.h"
 
-class BasisNC
+class Basis
 {
   public:
     /** \brief Creates an instance of class Basis.
@@ -31,55 +34,64 @@ class BasisNC
       * please refer to Section 2 (Background) and Section 3 (Basis representation) of the manuscript
       * in /docs.
       */
-    BasisNC(const EnvironmentNC &env);
+    Basis(const Environment &env);
     /** \brief Destructor.
       * 
       * Deallocates memory needed for the computational representation of the basis.
       */ 
-    ~BasisNC();
+    ~Basis();
     /// Copy constructor.
-    BasisNC(const BasisNC &rhs);
+    Basis(const Basis &rhs);
     /// Overloading of the assignment operator.
-    BasisNC &operator=(const BasisNC &rhs);
+    Basis &operator=(const Basis &rhs);
     /** \brief Computes and distributes (using MPI) the representation of the basis elements.
       *
       * This should be called after creating an instance of Basis and before
-      * constructing a Hamiltonian matrix. For more details, refer to Section 3.1 (Node communicator
-      * approach) of the manuscript in /docs. This routine will account for the specific distribution
-      * given to the first process of each node.
+      * constructing a Hamiltonian matrix. For more details, refer to Section 3.1 of the manuscript
+      * in /docs. This routine will account for the specific distribution of the lookup policy, the
+      * shared window is complete on every process of the node when it returns.
       */
     void construct_int_basis();
     /** \brief Outputs the integer representation of the basis to stdout.
       * \param env An instance of class Environment.
       * \param bits If bits = true, outputs a bit representation.
       */
-    void print_basis(const EnvironmentNC &env, 
+    void print_basis(const Environment &env, 
                      bool bits = false);
     /** \brief Computes and distributes (using MPI) the representation of the basis elements
       *        in binary form, this is normally used for visualisation purposes.
       */
     void construct_bit_basis(boost::dynamic_bitset<> *bit_basis);
     LLInt basis_size; ///< Dimension of the Hilbert space.
-    PetscInt basis_local; ///< Local value (MPI) of the dimension of the Hilbert space.
-    PetscInt basis_start; ///< Global index per processor.
+    PetscInt basis_local; ///< Number of elements held in int_basis.
+    PetscInt basis_start; ///< Global index of the first element of int_basis.
     PetscInt nlocal; ///< Local amount of rows owned by processor (PETSc).
     PetscInt start; ///< Global index (PETSc).
     PetscInt end; ///< Global index (PETSc).
-    LLInt *int_basis; ///< Container of the elements of the basis, locally owned. This array is of
-                      ///< size basis_size for the first process of each node 
+    State *int_basis; ///< Container of the elements of the basis, locally held. This array is of
+                      ///< size basis_size for the first process of each node (node) or shared
+                      ///< by the node (window). Always in lexicographic order, also when the
+                      ///< matrix rows are reordered.
+    Sector sector; ///< Encoding, enumeration and ranking of the elements.
   
   private:
     unsigned int l_; ///< Number of sites.
     unsigned int n_; ///< Subspace descriptor.
+    PetscInt fill_start_; ///< Global index of the first element computed by this process.
+    PetscInt fill_local_; ///< Number of elements computed by this process.
+    MPI_Comm node_comm_; ///< The node communicator of the environment.
+    MPI_Win window_; ///< Shared window of int_basis with the window policy, MPI_WIN_NULL otherwise.
     /** \brief Computes the factorial of an integer.
      *  \param n Integer value.
      *  \return The factorial of the number.
      */
     LLInt factorial_(LLInt n); 
-    /** \brief Computes the first integer representation of the basis vector locally owned.
-     *  \return The integer representation.
+    /** \brief Computes the first element of the basis computed by this process.
+     *  \return The basis element.
      */
-    LLInt first_int_();
+    State first_int_();
+    /// Frees int_basis, or the shared window that holds it.
+    void destroy_int_basis_();
 };
 #endif
 /** @}*/
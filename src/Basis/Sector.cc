@@ -0,0 +1,369 @@
+#include "Sector.h"
+#include "../Utils/Utils.h"
+
+/*******************************************************************************/
+// Single custom constructor for this class. The table of the Bose-Hubbard
+// ranking follows from adding one site at a time, with occupations 0 to
+// max_occupation
+/*******************************************************************************/
+Sector::Sector(const Environment &env)
+{
+  model_ = env.model;
+  statistics_ = env.statistics;
+  l_ = env.l;
+  n_ = env.n;
+  n_down_ = env.n_down;
+  max_occ_ = env.max_occupation;
+
+  width_ = 1;
+  if(model_ == Environment::MODEL_BOSE_HUBBARD)
+    while(max_occ_ >> width_) ++width_;
+
+  bits_ = width_ * l_;
+  if(model_ == Environment::MODEL_HUBBARD) bits_ = 2 * l_;
+
+  if(model_ == Environment::MODEL_BOSE_HUBBARD){
+    ways_.assign((l_ + 1) * (n_ + 1), 0);
+    ways_[0] = 1;
+    for(unsigned int k = 1; k <= l_; ++k){
+      for(unsigned int m = 0; m <= n_; ++m){
+        ULLInt w = 0;
+        for(unsigned int occ = 0; occ <= max_occ_ && occ <= m; ++occ)
+          w += ways_of_(k - 1, m - occ);
+        ways_[k * (n_ + 1) + m] = std::min(w, static_cast<ULLInt> (LLONG_MAX));
+      }
+    }
+  }
+}
+
+LLInt Sector::size() const
+{
+  if(model_ == Environment::MODEL_HUBBARD){
+    LLInt up = Utils::binomial(l_, n_);
+    LLInt down = Utils::binomial(l_, n_down_);
+    if(down && up > LLONG_MAX / down) return LLONG_MAX;
+    return up * down;
+  }
+  if(model_ == Environment::MODEL_BOSE_HUBBARD) return ways_of_(l_, n_);
+
+  return Utils::binomial(l_, n_);
+}
+
+/*******************************************************************************/
+// Hubbard species are ranked as in Utils::rank_state(), on their own bits
+/*******************************************************************************/
+LLInt Sector::rank_species_(const State &state, unsigned int offset) const
+{
+  LLInt index = 0;
+  LLInt k = 0;
+
+  for(unsigned int pos = 0; pos < l_; ++pos)
+    if(Utils::occupied(state, offset + pos)) index += Utils::binomial(pos, ++k);
+
+  return index;
+}
+
+void Sector::unrank_species_(State &state, LLInt index, unsigned int n,
+                             unsigned int offset) const
+{
+  LLInt pos = l_;
+
+  for(LLInt k = n; k > 0; --k){
+    do{
+      --pos;
+    } while(Utils::binomial(pos, k) > index);
+
+    Utils::flip(state, offset + pos);
+    index -= Utils::binomial(pos, k);
+  }
+}
+
+/*******************************************************************************/
+// Same permutation as Utils::next_state(), restricted to the bits of the
+// species: the lowest block of particles loses its top one to the next site
+// and the rest of the block moves down to the first sites
+/*******************************************************************************/
+bool Sector::next_species_(State &state, unsigned int n, unsigned int offset) const
+{
+  if(n == 0) return false;
+
+  unsigned int low = offset;
+  while(!Utils::occupied(state, low)) ++low;
+  unsigned int high = low;
+  while(high + 1 < offset + l_ && Utils::occupied(state, high + 1)) ++high;
+  if(high + 1 == offset + l_) return false;
+
+  state = Utils::hop(state, high, high + 1);
+  for(unsigned int pos = low; pos < high; ++pos) Utils::flip(state, pos);
+  for(unsigned int pos = offset; pos < offset + high - low; ++pos) Utils::flip(state, pos);
+
+  return true;
+}
+
+unsigned int Sector::occupation(const State &state, unsigned int site) const
+{
+  if(model_ == Environment::MODEL_HUBBARD)
+    return Utils::occupied(state, site) + Utils::occupied(state, l_ + site);
+
+  unsigned int occ = 0;
+  for(unsigned int b = 0; b < width_; ++b)
+    if(Utils::occupied(state, width_ * site + b)) occ |= 1U << b;
+
+  return occ;
+}
+
+void Sector::set_occupation_(State &state, unsigned int site, unsigned int occ) const
+{
+  for(unsigned int b = 0; b < width_; ++b)
+    if(Utils::occupied(state, width_ * site + b) != static_cast<bool> ((occ >> b) & 1))
+      Utils::flip(state, width_ * site + b);
+}
+
+/*******************************************************************************/
+// Bose-Hubbard: the elements with the same occupations of the higher sites and
+// a smaller one on a site come first, the lower sites holding the rest of the
+// particles in any of their configurations
+/*******************************************************************************/
+LLInt Sector::rank(const State &state) const
+{
+  if(model_ == Environment::MODEL_SPINLESS) return Utils::rank_state(state, l_);
+  if(model_ == Environment::MODEL_HUBBARD)
+    return rank_species_(state, l_) * Utils::binomial(l_, n_down_) + rank_species_(state, 0);
+
+  LLInt index = 0;
+  unsigned int m = n_;
+  for(unsigned int site = l_; site-- > 0;){
+    unsigned int occ = occupation(state, site);
+    for(unsigned int lower = 0; lower < occ; ++lower) index += ways_of_(site, m - lower);
+    m -= occ;
+  }
+
+  return index;
+}
+
+State Sector::unrank(LLInt index) const
+{
+  if(model_ == Environment::MODEL_SPINLESS) return Utils::unrank_state(index, l_, n_);
+
+  State state = State();
+  if(model_ == Environment::MODEL_HUBBARD){
+    LLInt down_size = Utils::binomial(l_, n_down_);
+    unrank_species_(state, index / down_size, n_, l_);
+    unrank_species_(state, index % down_size, n_down_, 0);
+    return state;
+  }
+
+  unsigned int m = n_;
+  for(unsigned int site = l_; site-- > 0;){
+    unsigned int occ = 0;
+    while(index >= ways_of_(site, m - occ)){
+      index -= ways_of_(site, m - occ);
+      ++occ;
+    }
+    set_occupation_(state, site, occ);
+    m -= occ;
+  }
+
+  return state;
+}
+
+/*******************************************************************************/
+// Hubbard: the down species advances, once it runs out the up species advances
+// and the down one restarts. Bose-Hubbard: the lowest site that can take one
+// more particle from the sites below it does, and the remaining particles of
+// those sites are packed from site 0
+/*******************************************************************************/
+State Sector::next(const State &state) const
+{
+  if(model_ == Environment::MODEL_SPINLESS) return Utils::next_state(state);
+
+  State next = state;
+  if(model_ == Environment::MODEL_HUBBARD){
+    if(!next_species_(next, n_down_, 0)){
+      for(unsigned int pos = 0; pos < l_; ++pos)
+        if(Utils::occupied(next, pos) != (pos < n_down_)) Utils::flip(next, pos);
+      next_species_(next, n_, l_);
+    }
+    return next;
+  }
+
+  unsigned int below = occupation(state, 0);
+  unsigned int site = 1;
+  while(below == 0 || occupation(state, site) == max_occ_) below += occupation(state, site++);
+
+  set_occupation_(next, site, occupation(state, site) + 1);
+  below -= 1;
+  for(unsigned int lower = 0; lower < site; ++lower){
+    unsigned int occ = std::min(below, max_occ_);
+    set_occupation_(next, lower, occ);
+    below -= occ;
+  }
+
+  return next;
+}
+
+unsigned int Sector::interaction(const State &state) const
+{
+  unsigned int count = 0;
+
+  for(unsigned int site = 0; site < l_; ++site){
+    if(model_ == Environment::MODEL_SPINLESS){
+      if(Utils::occupied(state, site) && Utils::occupied(state, (site + 1) % l_)) ++count;
+    }
+    else if(model_ == Environment::MODEL_HUBBARD){
+      if(Utils::occupied(state, site) && Utils::occupied(state, l_ + site)) ++count;
+    }
+    else{
+      unsigned int occ = occupation(state, site);
+      count += occ * (occ - 1) / 2;
+    }
+  }
+
+  return count;
+}
+
+unsigned int Sector::max_hops() const
+{
+  return (model_ == Environment::MODEL_SPINLESS) ? l_ : 2 * l_;
+}
+
+/*******************************************************************************/
+// Hard-core particles hop if the occupation of both sites differs, the down
+// species first for the Hubbard model. Bosons hop in both directions
+/*******************************************************************************/
+unsigned int Sector::hops(const State &state, State *targets, double *factors) const
+{
+  unsigned int count = 0;
+
+  if(model_ != Environment::MODEL_BOSE_HUBBARD){
+    unsigned int species = (model_ == Environment::MODEL_HUBBARD) ? 2 : 1;
+    for(unsigned int s = 0; s < species; ++s){
+      unsigned int offset = s * l_;
+      for(unsigned int site = 0; site < l_; ++site){
+        unsigned int from = offset + site;
+        unsigned int to = offset + (site + 1) % l_;
+        if(Utils::occupied(state, from) == Utils::occupied(state, to)) continue;
+
+        targets[count] = Utils::hop(state, from, to);
+        factors[count] = 1.0;
+        if(statistics_ == Environment::FERMIONS)
+          factors[count] = Utils::hop_sign(state, from, to);
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  for(unsigned int site = 0; site < l_; ++site){
+    unsigned int next_site = (site + 1) % l_;
+    if(next_site == site) continue;
+
+    unsigned int occ = occupation(state, site);
+    unsigned int next_occ = occupation(state, next_site);
+    if(occ > 0 && next_occ < max_occ_){
+      targets[count] = state;
+      set_occupation_(targets[count], site, occ - 1);
+      set_occupation_(targets[count], next_site, next_occ + 1);
+      factors[count++] = std::sqrt(static_cast<double> (occ * (next_occ + 1)));
+    }
+    if(next_occ > 0 && occ < max_occ_){
+      targets[count] = state;
+      set_occupation_(targets[count], site, occ + 1);
+      set_occupation_(targets[count], next_site, next_occ - 1);
+      factors[count++] = std::sqrt(static_cast<double> (next_occ * (occ + 1)));
+    }
+  }
+
+  return count;
+}
+
+LLInt Sector::row_nnz(const State &state) const
+{
+  if(model_ == Environment::MODEL_SPINLESS) return Utils::row_nnz_estimate(state, l_);
+
+  LLInt nnz = 1;
+  for(unsigned int site = 0; site < l_; ++site){
+    unsigned int next_site = (site + 1) % l_;
+    if(model_ == Environment::MODEL_HUBBARD){
+      if(Utils::occupied(state, site) != Utils::occupied(state, next_site)) ++nnz;
+      if(Utils::occupied(state, l_ + site) != Utils::occupied(state, l_ + next_site)) ++nnz;
+    }
+    else if(next_site != site){
+      unsigned int occ = occupation(state, site);
+      unsigned int next_occ = occupation(state, next_site);
+      if(occ > 0 && next_occ < max_occ_) ++nnz;
+      if(next_occ > 0 && occ < max_occ_) ++nnz;
+    }
+  }
+
+  return nnz;
+}
+
+/*******************************************************************************/
+// On a ring every hard-core particle has two neighbouring sites, each empty
+// with probability (l - n) / (l - 1). Bosons are bounded by two hops per
+// particle
+/*******************************************************************************/
+double Sector::average_hops() const
+{
+  if(l_ < 2) return 0.0;
+
+  double hops = 2.0 * n_ * (l_ - n_) / (l_ - 1);
+  if(model_ == Environment::MODEL_HUBBARD) hops += 2.0 * n_down_ * (l_ - n_down_) / (l_ - 1);
+  if(model_ == Environment::MODEL_BOSE_HUBBARD) hops = 2.0 * std::min(n_, l_);
+
+  return hops;
+}
+
+bool Sector::neel(State &state) const
+{
+  unsigned int even = (l_ + 1) / 2;
+  if(n_ != even) return false;
+  if(model_ == Environment::MODEL_HUBBARD && n_down_ != l_ - even) return false;
+
+  state = State();
+  for(unsigned int site = 0; site < l_; ++site){
+    if(site % 2 == 0){
+      if(model_ == Environment::MODEL_BOSE_HUBBARD) set_occupation_(state, site, 1);
+      else Utils::flip(state, site + ((model_ == Environment::MODEL_HUBBARD) ? l_ : 0));
+    }
+    else if(model_ == Environment::MODEL_HUBBARD){
+      Utils::flip(state, site);
+    }
+  }
+
+  return true;
+}
+
+bool Sector::product_state(const std::string &pattern, State &state) const
+{
+  if(pattern.size() != l_) return false;
+
+  state = State();
+  unsigned int up = 0;
+  unsigned int down = 0;
+  for(unsigned int site = 0; site < l_; ++site){
+    char c = pattern[site];
+    if(model_ == Environment::MODEL_HUBBARD){
+      if(c != '0' && c != 'u' && c != 'd' && c != '2') return false;
+      if(c == 'u' || c == '2'){
+        Utils::flip(state, l_ + site);
+        ++up;
+      }
+      if(c == 'd' || c == '2'){
+        Utils::flip(state, site);
+        ++down;
+      }
+    }
+    else{
+      unsigned int max_occ = (model_ == Environment::MODEL_BOSE_HUBBARD) ? max_occ_ : 1;
+      if(c < '0' || c > '9' || static_cast<unsigned int> (c - '0') > max_occ) return false;
+      unsigned int occ = c - '0';
+      if(model_ == Environment::MODEL_BOSE_HUBBARD) set_occupation_(state, site, occ);
+      else if(occ) Utils::flip(state, site);
+      up += occ;
+    }
+  }
+
+  return up == n_ && (model_ != Environment::MODEL_HUBBARD || down == n_down_);
+}
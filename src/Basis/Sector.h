@@ -0,0 +1,132 @@
+/** @addtogroup Core
+ * @{
+ */
+/**
+ * \class Sector
+ * \ingroup Core
+ * \brief Encoding of the basis elements of a particle number sector.
+ *
+ * Every model stores its configurations in a State (see State.h), such that the integer
+ * order of the States is the order of the basis, and provides the enumeration in that order,
+ * the ranking (global index of an element) and the action of the hopping term:
+ * - Spinless (-model spinless): one bit per site, n particles.
+ * - Hubbard (-model hubbard): two species on l sites, n up and n_down down particles. The down
+ *   species takes bits 0 to l - 1 and the up species bits l to 2 l - 1, so the basis is the
+ *   product of both species (up major) and the index is rank(up) C(l, n_down) + rank(down).
+ * - Bose-Hubbard (-model bose_hubbard): n bosons with at most max_occupation per site, the
+ *   occupation of site i stored in bits w i to w i + w - 1 (mixed radix, w bits per site). The
+ *   ranking counts the configurations of the lower sites with a table, as the combinatorial
+ *   number system does for the spinless case.
+ *
+ * Hops are enumerated in a fixed order, so the different passes of the construction of the
+ * Hamiltonian see the same sequence for every element.
+ */
+#ifndef __SECTOR_H
+#define __SECTOR_H
+
+#include <string>
+#include <vector>
+
+#include "../Environment/Environment.h"
+#include "State.h"
+
+class Sector
+{
+  public:
+    /** \brief Creates the encoding of the sector given by the runtime options.
+      * \param env An instance of the class Environment.
+      */
+    Sector(const Environment &env);
+    /// Dimension of the sector, saturates at LLONG_MAX.
+    LLInt size() const;
+    /// Number of bits of a State used by the encoding.
+    unsigned int bits() const { return bits_; }
+    /** \brief Computes a basis element from its global index.
+      * \param index Global index of the element.
+      * \return The element.
+      */
+    State unrank(LLInt index) const;
+    /** \brief Computes the global index of a basis element, inverse of unrank().
+      * \param state A basis element.
+      * \return Global index of the element.
+      */
+    LLInt rank(const State &state) const;
+    /** \brief Computes the next basis element in order.
+      * \param state A basis element, other than the last one.
+      * \return The next element.
+      */
+    State next(const State &state) const;
+    /** \brief Number of particles on a site, both species for the Hubbard model.
+      * \param state A basis element.
+      * \param site The site.
+      */
+    unsigned int occupation(const State &state,
+                            unsigned int site) const;
+    /** \brief Interaction count of a basis element, multiplied by V in the Hamiltonian.
+      * \param state A basis element.
+      * \return Pairs of occupied neighbouring sites (spinless), doubly occupied sites
+      *         (Hubbard) or the sum of n_i (n_i - 1) / 2 (Bose-Hubbard).
+      */
+    unsigned int interaction(const State &state) const;
+    /// Largest number of hops of an element, size of the arrays given to hops().
+    unsigned int max_hops() const;
+    /** \brief Enumerates the hops of a basis element, towards the next site of the ring.
+      * \param state A basis element.
+      * \param targets The elements reached by every hop.
+      * \param factors Factor of the hopping amplitude t of every hop: the fermionic sign (see
+      *                Utils::hop_sign()) or the bosonic sqrt(n_i (n_j + 1)).
+      * \return The number of hops.
+      */
+    unsigned int hops(const State &state,
+                      State *targets,
+                      double *factors) const;
+    /// Number of non-zero entries of the Hamiltonian row of an element, one per hop plus the diagonal.
+    LLInt row_nnz(const State &state) const;
+    /// Average number of hops per element, for the memory prediction.
+    double average_hops() const;
+    /** \brief Neel state, a particle on every other site starting at site 0.
+      * \param state The element, the down species on the remaining sites for the Hubbard model.
+      * \return False if the number of particles of the sector does not match.
+      */
+    bool neel(State &state) const;
+    /** \brief Product state given by the occupation of every site.
+      * \param pattern One character per site: 0 or 1 (spinless), the occupation 0 to 9
+      *                (Bose-Hubbard) or 0, u, d, 2 (Hubbard, empty, up, down, doubly occupied).
+      * \param state The element.
+      * \return False if the pattern is not valid or its number of particles does not match.
+      */
+    bool product_state(const std::string &pattern,
+                       State &state) const;
+
+  private:
+    Environment::Model model_; ///< Encoding.
+    Environment::Statistics statistics_; ///< Sign convention of the hops.
+    unsigned int l_; ///< Number of sites.
+    unsigned int n_; ///< Number of particles (up species for the Hubbard model).
+    unsigned int n_down_; ///< Number of down particles (Hubbard).
+    unsigned int max_occ_; ///< Largest occupation of a site (Bose-Hubbard).
+    unsigned int width_; ///< Bits per site.
+    unsigned int bits_; ///< Bits per element.
+    std::vector<LLInt> ways_; ///< Bose-Hubbard configurations of m particles on k sites, at k (n + 1) + m.
+    /// Configurations of m bosons on the first k sites.
+    LLInt ways_of_(unsigned int k,
+                   unsigned int m) const { return ways_[k * (n_ + 1) + m]; }
+    /// Index of the particles of a species within its own combinations.
+    LLInt rank_species_(const State &state,
+                        unsigned int offset) const;
+    /// Places the combination of the given index on the bits of a species.
+    void unrank_species_(State &state,
+                         LLInt index,
+                         unsigned int n,
+                         unsigned int offset) const;
+    /// Next combination of a species, false if it was the last one.
+    bool next_species_(State &state,
+                       unsigned int n,
+                       unsigned int offset) const;
+    /// Replaces the occupation of a site (Bose-Hubbard).
+    void set_occupation_(State &state,
+                         unsigned int site,
+                         unsigned int occ) const;
+};
+#endif
+/** @}*/
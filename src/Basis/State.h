@@ -0,0 +1,176 @@
+/** @addtogroup Core
+ * @{
+ */
+/**
+ * \file State.h
+ * \ingroup Core
+ * \brief Representation of the elements of the basis, one bit per site.
+ *
+ * By default an element is a single 64-bit integer, which limits the system to 63 sites.
+ * Longer chains, normally with few particles, are supported by compiling with
+ * STATE_WORDS=w (see Makefile), which stores every element in w words of 64 bits.
+ * The kernels acting on single sites are overloaded for both representations, so the
+ * single word one keeps its plain integer operations.
+ */
+#ifndef __STATE_H
+#define __STATE_H
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+#include "../Environment/Environment.h"
+
+#ifndef STATE_WORDS
+#define STATE_WORDS 1
+#endif
+
+/** \brief Bit string of W words, the least significant one first.
+  *
+  * The order is the one of the equivalent (W x 64)-bit integer, so the basis stays sorted
+  * as with the single word representation.
+  */
+template <unsigned int W>
+class MultiWord
+{
+  public:
+    /// Creates the empty string, no sites occupied.
+    MultiWord()
+    {
+      for(unsigned int i = 0; i < W; ++i) words[i] = 0;
+    }
+    bool operator<(const MultiWord &rhs) const
+    {
+      for(unsigned int i = W; i-- > 0;)
+        if(words[i] != rhs.words[i]) return words[i] < rhs.words[i];
+      return false;
+    }
+    bool operator==(const MultiWord &rhs) const
+    {
+      for(unsigned int i = 0; i < W; ++i)
+        if(words[i] != rhs.words[i]) return false;
+      return true;
+    }
+    bool operator!=(const MultiWord &rhs) const { return !(*this == rhs); }
+
+    ULLInt words[W]; ///< Site i is bit i % 64 of word i / 64.
+};
+
+/// Prints the string as a hexadecimal integer.
+template <unsigned int W>
+std::ostream &operator<<(std::ostream &os, const MultiWord<W> &s)
+{
+  std::ios_base::fmtflags flags = os.flags();
+  char fill = os.fill('0');
+
+  os << "0x" << std::hex;
+  for(unsigned int i = W; i-- > 0;) os << std::setw(16) << s.words[i];
+
+  os.flags(flags);
+  os.fill(fill);
+  return os;
+}
+
+#if STATE_WORDS == 1
+typedef LLInt State; ///< Element of the basis.
+#else
+typedef MultiWord<STATE_WORDS> State; ///< Element of the basis.
+#endif
+
+/// Largest number of sites an element of the basis can represent.
+const unsigned int STATE_MAX_SITES = (STATE_WORDS == 1) ? 63 : 64 * STATE_WORDS;
+
+namespace Utils
+{
+  /** \brief Occupation of a site.
+    * \param s An element of the basis.
+    * \param site The site.
+    * \return Whether the site is occupied.
+    */
+  inline bool occupied(LLInt s, unsigned int site)
+  {
+    return (s >> site) & 1;
+  }
+  /** \brief Changes the occupation of a site.
+    * \param s An element of the basis.
+    * \param site The site.
+    */
+  inline void flip(LLInt &s, unsigned int site)
+  {
+    s ^= 1LL << site;
+  }
+  /** \brief Moves a particle between two sites of different occupation.
+    * \param s An element of the basis.
+    * \param from A site.
+    * \param to Another site.
+    * \return The element with the occupation of both sites exchanged.
+    */
+  inline LLInt hop(LLInt s, unsigned int from, unsigned int to)
+  {
+    return s ^ ((1LL << from) | (1LL << to));
+  }
+  /** \brief Number of particles of an element of the basis.
+    * \param s An element of the basis.
+    * \return The number of occupied sites.
+    */
+  inline unsigned int particles(LLInt s)
+  {
+    return __builtin_popcountll(s);
+  }
+  /** \brief Fermionic sign of a hop, from the Jordan-Wigner string between both sites.
+    * \param s An element of the basis, before or after the hop.
+    * \param from A site.
+    * \param to Another site.
+    * \return -1 if an odd number of particles sits strictly between both sites, 1 otherwise.
+    *
+    * Valid for hops of any range, e.g. the one across the boundary of the ring gets (-1)^(n - 1).
+    */
+  inline int hop_sign(LLInt s, unsigned int from, unsigned int to)
+  {
+    unsigned int lo = std::min(from, to);
+    unsigned int hi = std::max(from, to);
+    ULLInt mask = ((1ULL << hi) - 1) & (~0ULL << lo << 1);
+    return (__builtin_popcountll(s & mask) & 1) ? -1 : 1;
+  }
+
+  template <unsigned int W>
+  inline bool occupied(const MultiWord<W> &s, unsigned int site)
+  {
+    return (s.words[site >> 6] >> (site & 63)) & 1;
+  }
+  template <unsigned int W>
+  inline void flip(MultiWord<W> &s, unsigned int site)
+  {
+    s.words[site >> 6] ^= 1ULL << (site & 63);
+  }
+  template <unsigned int W>
+  inline MultiWord<W> hop(MultiWord<W> s, unsigned int from, unsigned int to)
+  {
+    flip(s, from);
+    flip(s, to);
+    return s;
+  }
+  template <unsigned int W>
+  inline unsigned int particles(const MultiWord<W> &s)
+  {
+    unsigned int count = 0;
+    for(unsigned int i = 0; i < W; ++i) count += __builtin_popcountll(s.words[i]);
+    return count;
+  }
+  template <unsigned int W>
+  inline int hop_sign(const MultiWord<W> &s, unsigned int from, unsigned int to)
+  {
+    unsigned int lo = std::min(from, to) + 1;
+    unsigned int hi = std::max(from, to);
+    unsigned int count = 0;
+    for(unsigned int i = lo >> 6; lo < hi && i <= (hi >> 6); ++i){
+      ULLInt mask = ~0ULL;
+      if(i == (lo >> 6)) mask &= ~0ULL << (lo & 63);
+      if(i == (hi >> 6)) mask &= (1ULL << (hi & 63)) - 1;
+      count += __builtin_popcountll(s.words[i] & mask);
+    }
+    return (count & 1) ? -1 : 1;
+  }
+}
+#endif
+/** @}*/
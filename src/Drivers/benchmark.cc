@@ -0,0 +1,584 @@
+/** @addtogroup Core */
+/** @file */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+#include "../Environment/Environment.h"
+#include "../Utils/Utils.h"
+#include "../Log/Log.h"
+#include "../Basis/Basis.h"
+#include "../Basis/Sector.h"
+#include "../Operators/SparseOp.h"
+#include "../InitialState/InitialState.h"
+#include "../TimeEvo/KrylovEvo.h"
+
+/// Parameters of the benchmark, common to all the points of the sweep.
+struct BenchOptions
+{
+  std::vector<PetscInt> sites; ///< Number of sites of the points.
+  std::vector<PetscInt> particles; ///< Number of particles of the points.
+  bool n_down_set; ///< Whether the down particles of the Hubbard model are fixed by -n_down.
+  bool max_occupation_set; ///< Whether the occupation of the Bose-Hubbard model is fixed.
+  PetscInt repeats; ///< Repetitions of every point, each one built from scratch.
+  PetscInt matmults; ///< Timed matrix-vector products.
+  double evo_time; ///< Length of the timed evolution.
+  double tol; ///< Tolerance of the propagator.
+  int maxits; ///< Maximum number of iterations of the propagator.
+  KrylovEvo::Method method; ///< Method of the propagator.
+  PetscInt krylov_dim; ///< Dimension of the Krylov subspace, SLEPc's default if not positive.
+  double V; ///< Interaction strength.
+  double t; ///< Hopping amplitude.
+  double h; ///< Strength of the quasi-periodic potential.
+  double beta; ///< Frequency of the quasi-periodic potential.
+  std::string output; ///< File the records are appended to, stdout if empty.
+  bool utils; ///< Microbenchmarks of the kernels of Utils instead of the phases.
+  PetscInt queries; ///< Calls of every kernel in the microbenchmarks.
+};
+
+/// Kernels of Utils as they were first written, the reference of the microbenchmarks.
+namespace Reference
+{
+  /// Modulus with two divisions.
+  LLInt mod(LLInt a, LLInt b)
+  {
+    return (a % b + b) % b;
+  }
+
+  /// Conversion visiting every bit.
+  LLInt binary_to_int(const boost::dynamic_bitset<> &bs, unsigned int l)
+  {
+    LLInt integer = 0;
+    for(unsigned int i = 0; i < l; ++i){
+      if(bs[i] == 1){
+        integer += 1ULL << i;
+      }
+    }
+    return integer;
+  }
+
+  /// Recursive binary search with an early exit.
+  LLInt binsearch(const State *array, LLInt len, const State &value)
+  {
+    if(len == 0) return -1;
+    LLInt mid = len / 2;
+
+    if(array[mid] == value)
+      return mid;
+    else if(array[mid] < value){
+      LLInt result = binsearch(array + mid + 1, len - (mid + 1), value);
+      return (result == -1) ? -1 : result + mid + 1;
+    }
+    else
+      return binsearch(array, mid, value);
+  }
+
+  /// Search with the standard library.
+  LLInt lower_bound(const State *array, LLInt len, const State &value)
+  {
+    const State *it = std::lower_bound(array, array + len, value);
+    return (it != array + len && *it == value) ? it - array : -1;
+  }
+}
+
+/** \brief Wall time since a given instant, taken by the slowest process.
+  * \param start Instant given by MPI_Wtime() on every process.
+  * \param comm Communicator of the processes.
+  * \return Largest elapsed time, in seconds.
+  */
+double elapsed_max(double start,
+                   MPI_Comm comm)
+{
+  double elapsed = MPI_Wtime() - start;
+  MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, comm);
+  return elapsed;
+}
+
+/** \brief Wall time of an event since a snapshot of the log, taken by the slowest process.
+  * \param before Time of every event at the snapshot, see Log::event_seconds().
+  * \param event The event.
+  * \param comm Communicator of the processes.
+  * \return Largest time spent in the event since the snapshot, in seconds.
+  */
+double event_delta(const std::vector<double> &before,
+                   Log::Event event,
+                   MPI_Comm comm)
+{
+  double elapsed = Log::event_seconds(event) - before[event];
+  MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, comm);
+  return elapsed;
+}
+
+/** \brief Opens a hardware counter of the cache misses of the calling process.
+  * \return Descriptor of the counter, negative if it is not available (e.g. not Linux, or
+  *         perf_event_paranoid forbids it).
+  */
+int cache_counter_open()
+{
+#if defined(__linux__)
+  struct perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = PERF_COUNT_HW_CACHE_MISSES;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+  return -1;
+#endif
+}
+
+/// Resets and starts the counter, if available.
+void cache_counter_start(int fd)
+{
+#if defined(__linux__)
+  if(fd < 0) return;
+  ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+  ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+/// Stops the counter and returns the misses since cache_counter_start(), negative if unavailable.
+double cache_counter_stop(int fd)
+{
+#if defined(__linux__)
+  if(fd < 0) return -1.0;
+  ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+  long long count;
+  if(read(fd, &count, sizeof(count)) != sizeof(count)) return -1.0;
+  return static_cast<double> (count);
+#else
+  return -1.0;
+#endif
+}
+
+/// Uniform random 64-bit integer attached to an index, see Utils::philox().
+ULLInt random_word(ULLInt index)
+{
+  boost::uint32_t counter[4] = {static_cast<boost::uint32_t> (index),
+                                static_cast<boost::uint32_t> (index >> 32), 0, 0};
+  boost::uint32_t key[2] = {0x5eed, 0};
+  boost::uint32_t result[4];
+  Utils::philox(counter, key, result);
+  return (static_cast<ULLInt> (result[1]) << 32) | result[0];
+}
+
+/** \brief Writes the record of a kernel, collective.
+  * \param env The environment.
+  * \param kernel Name of the kernel.
+  * \param implementation Name of the implementation.
+  * \param size Elements of the searched array, zero for the other kernels.
+  * \param ops Calls of every process.
+  * \param seconds Time of the calls on the local process.
+  * \param misses Cache misses of the calls on the local process, negative if unavailable.
+  * \param mismatches Results that differ from the reference on the local process.
+  * \param out Stream of the records, used by the first process only.
+  * \return Mismatches of all the processes.
+  */
+LLInt write_kernel(const Environment &env,
+                   const char *kernel,
+                   const char *implementation,
+                   LLInt size,
+                   LLInt ops,
+                   double seconds,
+                   double misses,
+                   LLInt mismatches,
+                   std::ostream &out)
+{
+  double unavailable = (misses < 0.0) ? 1.0 : 0.0;
+  MPI_Allreduce(MPI_IN_PLACE, &seconds, 1, MPI_DOUBLE, MPI_MAX, env.comm);
+  MPI_Allreduce(MPI_IN_PLACE, &misses, 1, MPI_DOUBLE, MPI_SUM, env.comm);
+  MPI_Allreduce(MPI_IN_PLACE, &unavailable, 1, MPI_DOUBLE, MPI_MAX, env.comm);
+  MPI_Allreduce(MPI_IN_PLACE, &size, 1, MPIU_INT, MPI_MAX, env.comm);
+  MPI_Allreduce(MPI_IN_PLACE, &mismatches, 1, MPIU_INT, MPI_SUM, env.comm);
+
+  if(env.mpirank == 0){
+    out << "{\"approach\": \"" << env.approach() << "\", \"ranks\": " << env.mpisize
+      << ", \"l\": " << env.l << ", \"n\": " << env.n << ", \"kernel\": \"" << kernel
+      << "\", \"implementation\": \"" << implementation << "\", \"array\": " << size
+      << ", \"ops\": " << ops
+      << ", \"ns_per_op\": " << seconds * 1.0e9 / std::max(ops, static_cast<LLInt> (1))
+      << ", \"cache_misses_per_op\": "
+      << ((unavailable > 0.0) ? -1.0 : misses / std::max(ops * env.mpisize, static_cast<LLInt> (1)))
+      << ", \"mismatches\": " << mismatches << "}" << std::endl;
+  }
+
+  return mismatches;
+}
+
+/*******************************************************************************/
+// Every process searches its own part of the basis, with the queries of the
+// assembly: elements reached by a hop from randomly picked local elements, so
+// both hits and misses appear. The results of every implementation are first
+// compared with the reference, untimed, then every one is timed on its own
+/*******************************************************************************/
+/** \brief Microbenchmarks of the kernels of Utils for the current size, and differential check
+  *        against the reference implementations.
+  * \param env The environment.
+  * \param opts Parameters of the benchmark.
+  * \param out Stream of the records, used by the first process only.
+  * \return Mismatches of all the kernels and processes.
+  */
+LLInt bench_utils(Environment &env,
+                  const BenchOptions &opts,
+                  std::ostream &out)
+{
+  Basis basis(env);
+  basis.construct_int_basis();
+  const State *array = basis.int_basis;
+  LLInt len = basis.basis_local;
+
+  LLInt n_queries = std::max(opts.queries, static_cast<PetscInt> (1));
+  std::vector<State> queries(n_queries);
+  std::vector<State> targets(basis.sector.max_hops() + 1);
+  std::vector<double> factors(basis.sector.max_hops() + 1);
+  for(LLInt q = 0; q < n_queries; ++q){
+    if(len == 0) break;
+    ULLInt word = random_word(q);
+    const State &origin = array[word % len];
+    unsigned int hops = basis.sector.hops(origin, &targets[0], &factors[0]);
+    queries[q] = (hops == 0) ? origin : targets[(word >> 32) % hops];
+  }
+
+  int fd = cache_counter_open();
+  volatile LLInt sink = 0;
+  LLInt sum, mismatches = 0;
+
+  // Binary search
+  LLInt wrong = 0, wrong_std = 0;
+  for(LLInt q = 0; q < n_queries && len > 0; ++q){
+    LLInt expected = Reference::binsearch(array, len, queries[q]);
+    if(Utils::binsearch(array, len, queries[q]) != expected) ++wrong;
+    if(Reference::lower_bound(array, len, queries[q]) != expected) ++wrong_std;
+  }
+
+  const char *searches[3] = {"utils", "reference", "lower_bound"};
+  for(int k = 0; k < 3; ++k){
+    MPI_Barrier(env.comm);
+    cache_counter_start(fd);
+    double start = MPI_Wtime();
+    sum = 0;
+    for(LLInt q = 0; q < n_queries && len > 0; ++q){
+      if(k == 0) sum += Utils::binsearch(array, len, queries[q]);
+      else if(k == 1) sum += Reference::binsearch(array, len, queries[q]);
+      else sum += Reference::lower_bound(array, len, queries[q]);
+    }
+    double seconds = MPI_Wtime() - start;
+    double misses = cache_counter_stop(fd);
+    sink = sink + sum;
+    mismatches += write_kernel(env, "binsearch", searches[k], len, n_queries, seconds, misses,
+      (k == 0) ? wrong : ((k == 2) ? wrong_std : 0), out);
+  }
+
+  // Modulus, both signs of both operands
+  std::vector<LLInt> a(n_queries), b(n_queries);
+  for(LLInt q = 0; q < n_queries; ++q){
+    ULLInt word = random_word(q + n_queries);
+    a[q] = static_cast<LLInt> (word & 0xffffffffffULL) - (1LL << 39);
+    b[q] = static_cast<LLInt> ((word >> 40) & 0xfffffULL) + 1;
+    if(word >> 63) b[q] = -b[q];
+  }
+  wrong = 0;
+  for(LLInt q = 0; q < n_queries; ++q)
+    if(Utils::mod(a[q], b[q]) != Reference::mod(a[q], b[q])) ++wrong;
+
+  for(int k = 0; k < 2; ++k){
+    MPI_Barrier(env.comm);
+    cache_counter_start(fd);
+    double start = MPI_Wtime();
+    sum = 0;
+    for(LLInt q = 0; q < n_queries; ++q)
+      sum += (k == 0) ? Utils::mod(a[q], b[q]) : Reference::mod(a[q], b[q]);
+    double seconds = MPI_Wtime() - start;
+    double misses = cache_counter_stop(fd);
+    sink = sink + sum;
+    mismatches += write_kernel(env, "mod", searches[k], 0, n_queries, seconds, misses,
+      (k == 0) ? wrong : 0, out);
+  }
+
+  // Conversion of bitsets as wide as the elements, up to the 63 bits of the integer
+  unsigned int width = std::min(basis.sector.bits(), 63u);
+  LLInt n_bitsets = std::min(n_queries, static_cast<LLInt> (65536));
+  std::vector<boost::dynamic_bitset<> > bitsets(n_bitsets);
+  for(LLInt q = 0; q < n_bitsets; ++q){
+    ULLInt word = random_word(q + 2 * n_queries) & ((1ULL << width) - 1);
+    bitsets[q].resize(width);
+    for(unsigned int i = 0; i < width; ++i) bitsets[q][i] = (word >> i) & 1ULL;
+  }
+  wrong = 0;
+  for(LLInt q = 0; q < n_bitsets; ++q)
+    if(Utils::binary_to_int(bitsets[q], width) != Reference::binary_to_int(bitsets[q], width))
+      ++wrong;
+
+  for(int k = 0; k < 2; ++k){
+    MPI_Barrier(env.comm);
+    cache_counter_start(fd);
+    double start = MPI_Wtime();
+    sum = 0;
+    for(LLInt q = 0; q < n_queries; ++q){
+      const boost::dynamic_bitset<> &bs = bitsets[q % n_bitsets];
+      sum += (k == 0) ? Utils::binary_to_int(bs, width) : Reference::binary_to_int(bs, width);
+    }
+    double seconds = MPI_Wtime() - start;
+    double misses = cache_counter_stop(fd);
+    sink = sink + sum;
+    mismatches += write_kernel(env, "binary_to_int", searches[k], 0, n_queries, seconds, misses,
+      (k == 0) ? wrong : 0, out);
+  }
+
+#if defined(__linux__)
+  if(fd >= 0) close(fd);
+#endif
+
+  return mismatches;
+}
+
+/** \brief Sets the size of the system of a point of the sweep.
+  * \param env The environment, whose size is replaced.
+  * \param l Number of sites.
+  * \param n Number of particles.
+  * \param opts Parameters of the benchmark.
+  * \return False if the point is not valid for the model, with the checks of the environment.
+  *
+  * The down particles of the Hubbard model and the largest occupation of the Bose-Hubbard model
+  * follow the number of particles, unless they are given at runtime.
+  */
+bool set_point(Environment &env,
+               PetscInt l,
+               PetscInt n,
+               const BenchOptions &opts)
+{
+  env.l = l;
+  env.n = n;
+  if(!opts.n_down_set) env.n_down = n;
+  if(!opts.max_occupation_set) env.max_occupation = n;
+
+  if(l < 2 || n < 0) return false;
+  if(env.model != Environment::MODEL_BOSE_HUBBARD && (env.n > env.l || env.n_down > env.l))
+    return false;
+  if(env.model == Environment::MODEL_BOSE_HUBBARD && (env.max_occupation == 0
+    || env.n > static_cast<ULLInt> (env.l) * env.max_occupation)) return false;
+  return Sector(env).bits() <= STATE_MAX_SITES;
+}
+
+/*******************************************************************************/
+// Every phase is timed by the slowest process. The construction phases are
+// read from the log, so they are exactly those of -phase_summary. The traffic
+// of MatMult is the minimum one of the AIJ format: values and column indices
+// of the entries, row offsets, and the input and output vectors once each
+/*******************************************************************************/
+/** \brief Builds the basis and the Hamiltonian of the current size, times every phase, and
+  *        writes one record.
+  * \param env The environment.
+  * \param opts Parameters of the benchmark.
+  * \param repeat Index of the repetition.
+  * \param out Stream of the records, used by the first process only.
+  */
+void bench_point(Environment &env,
+                 const BenchOptions &opts,
+                 PetscInt repeat,
+                 std::ostream &out)
+{
+  std::vector<double> before(Log::N_EVENTS);
+  for(int i = 0; i < Log::N_EVENTS; ++i)
+    before[i] = Log::event_seconds(static_cast<Log::Event> (i));
+
+  MPI_Barrier(env.comm);
+  double start = MPI_Wtime();
+  Basis *basis = new Basis(env);
+  basis->construct_int_basis();
+  double basis_total = elapsed_max(start, env.comm);
+
+  MPI_Barrier(env.comm);
+  start = MPI_Wtime();
+  SparseOp *aubry = new SparseOp(env, *basis);
+  aubry->construct_AA_hamiltonian(basis->int_basis, opts.V, opts.t, opts.h, opts.beta);
+  double hamiltonian = elapsed_max(start, env.comm);
+  if(env.basis_reorder) aubry->reorder_rows();
+
+  InitialState *init = new InitialState(env, *basis);
+  init->typical_initial_state(0);
+  if(env.basis_reorder) init->reorder_rows(aubry->RowOrdering);
+
+  LLInt dim = basis->basis_size;
+  delete basis;
+
+  MatInfo info;
+  MatGetInfo(aubry->HamMat, MAT_GLOBAL_SUM, &info);
+  double nnz = info.nz_used;
+
+  // One product outside the timing sets up the scatter of the ghost entries
+  Vec y;
+  VecDuplicate(init->InitialVec, &y);
+  MatMult(aubry->HamMat, init->InitialVec, y);
+  MPI_Barrier(env.comm);
+  start = MPI_Wtime();
+  for(PetscInt k = 0; k < opts.matmults; ++k) MatMult(aubry->HamMat, init->InitialVec, y);
+  double matmult = elapsed_max(start, env.comm)
+    / std::max(opts.matmults, static_cast<PetscInt> (1));
+  VecDestroy(&y);
+
+  double flops = 8.0 * nnz;
+  double bytes = nnz * (sizeof(PetscScalar) + sizeof(PetscInt)) + (dim + 1.0) * sizeof(PetscInt)
+    + 2.0 * dim * sizeof(PetscScalar);
+
+  KrylovEvo *te = new KrylovEvo(aubry->HamMat, opts.tol, opts.maxits, opts.method);
+  te->set_dimensions(opts.krylov_dim, 1);
+  LLInt its = Log::counter_value(Log::COUNTER_KRYLOV_ITS);
+  MPI_Barrier(env.comm);
+  start = MPI_Wtime();
+  te->krylov_evo(opts.evo_time, 0.0, init->InitialVec);
+  double krylov = elapsed_max(start, env.comm);
+  its = Log::counter_value(Log::COUNTER_KRYLOV_ITS) - its;
+  delete te;
+
+  delete init;
+  delete aubry;
+
+  double basis_time = event_delta(before, Log::EVENT_BASIS, env.comm);
+  double distribution = event_delta(before, Log::EVENT_DISTRIBUTION, env.comm);
+  double preallocation = event_delta(before, Log::EVENT_PREALLOCATION, env.comm);
+  double exchange = event_delta(before, Log::EVENT_EXCHANGE, env.comm);
+  double insertion = event_delta(before, Log::EVENT_INSERTION, env.comm);
+  double assembly = event_delta(before, Log::EVENT_ASSEMBLY, env.comm);
+  double reorder = event_delta(before, Log::EVENT_REORDER, env.comm);
+
+  if(env.mpirank != 0) return;
+
+  const char *models[] = {"spinless", "hubbard", "bose_hubbard"};
+  out << "{\"approach\": \"" << env.approach() << "\", \"ranks\": " << env.mpisize
+    << ", \"model\": \"" << models[env.model] << "\", \"l\": " << env.l << ", \"n\": " << env.n
+    << ", \"repeat\": " << repeat << ", \"dim\": " << dim << ", \"nnz\": " << nnz
+    << ", \"basis_s\": " << basis_time << ", \"basis_total_s\": " << basis_total
+    << ", \"states_per_s\": " << dim / basis_time
+    << ", \"distribution_s\": " << distribution << ", \"preallocation_s\": " << preallocation
+    << ", \"exchange_s\": " << exchange << ", \"insertion_s\": " << insertion
+    << ", \"assembly_s\": " << assembly << ", \"hamiltonian_s\": " << hamiltonian
+    << ", \"nnz_per_s\": " << nnz / hamiltonian << ", \"reorder_s\": " << reorder
+    << ", \"matmult_s\": " << matmult << ", \"matmult_gflops\": " << flops / matmult * 1.0e-9
+    << ", \"matmult_gbytes_per_s\": " << bytes / matmult * 1.0e-9
+    << ", \"krylov_s\": " << krylov << ", \"krylov_its\": " << its << "}" << std::endl;
+}
+
+/** \brief Benchmark of the construction and evolution phases.
+  *
+  * Sweeps the product of -bench_l and -bench_n (-l and -n by default), building every point
+  * -bench_repeats times, and writes one JSON record per line (JSON Lines) for every build,
+  * to stdout or appended to -bench_output. Rank counts are swept by launching it several times.
+  * With -bench_utils, the kernels of Utils are timed and checked against their reference
+  * implementations instead, and the run fails if any result differs.
+  */
+int main(int argc, char **argv)
+{
+  // Default system, can be changed with -l and -n
+  unsigned int l = 16;
+  unsigned int n = 8;
+
+  Environment env(argc, argv, l, n);
+
+  if(env.n_groups > 1){
+    if(env.mpirank == 0) std::cerr << "The benchmark runs on a single group" << std::endl;
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+
+  BenchOptions opts;
+  const char *names[2] = {"-bench_l", "-bench_n"};
+  std::vector<PetscInt> *values[2] = {&opts.sites, &opts.particles};
+  const PetscInt defaults[2] = {static_cast<PetscInt> (env.l), static_cast<PetscInt> (env.n)};
+  for(int i = 0; i < 2; ++i){
+    PetscInt count = 256;
+    PetscBool flg;
+    values[i]->resize(count);
+    PetscOptionsGetIntArray(NULL, NULL, names[i], &(*values[i])[0], &count, &flg);
+    if(flg) values[i]->resize(count);
+    else values[i]->assign(1, defaults[i]);
+  }
+
+  PetscBool flg;
+  PetscOptionsHasName(NULL, NULL, "-n_down", &flg);
+  opts.n_down_set = flg;
+  PetscOptionsHasName(NULL, NULL, "-max_occupation", &flg);
+  opts.max_occupation_set = flg;
+
+  opts.repeats = 3;
+  opts.matmults = 100;
+  opts.evo_time = 1.0;
+  PetscOptionsGetInt(NULL, NULL, "-bench_repeats", &opts.repeats, NULL);
+  PetscOptionsGetInt(NULL, NULL, "-bench_matmults", &opts.matmults, NULL);
+  PetscOptionsGetReal(NULL, NULL, "-bench_evo_time", &opts.evo_time, NULL);
+
+  PetscOptionsHasName(NULL, NULL, "-bench_utils", &flg);
+  opts.utils = flg;
+  opts.queries = 1000000;
+  PetscOptionsGetInt(NULL, NULL, "-bench_queries", &opts.queries, NULL);
+
+  opts.tol = 1.0e-7;
+  PetscInt maxits = 1000000;
+  PetscOptionsGetReal(NULL, NULL, "-krylov_tol", &opts.tol, NULL);
+  PetscOptionsGetInt(NULL, NULL, "-krylov_maxits", &maxits, NULL);
+  opts.maxits = maxits;
+
+  const char *methods[] = {"expokit", "chebyshev"};
+  PetscInt method = 0;
+  PetscOptionsGetEList(NULL, NULL, "-evo_method", methods, 2, &method, NULL);
+  opts.method = (method == 1) ? KrylovEvo::METHOD_CHEBYSHEV : KrylovEvo::METHOD_EXPOKIT;
+  opts.krylov_dim = 0;
+  PetscOptionsGetInt(NULL, NULL, "-mfn_ncv", &opts.krylov_dim, NULL);
+
+  opts.V = 1.0;
+  opts.t = 1.0;
+  opts.h = 1.0;
+  opts.beta = (std::sqrt(5.0) - 1.0) / 2.0;
+  PetscOptionsGetReal(NULL, NULL, "-interaction", &opts.V, NULL);
+  PetscOptionsGetReal(NULL, NULL, "-hopping", &opts.t, NULL);
+  PetscOptionsGetReal(NULL, NULL, "-potential", &opts.h, NULL);
+  PetscOptionsGetReal(NULL, NULL, "-beta", &opts.beta, NULL);
+
+  char output[PETSC_MAX_PATH_LEN];
+  PetscOptionsGetString(NULL, NULL, "-bench_output", output, PETSC_MAX_PATH_LEN, &flg);
+  if(flg) opts.output = output;
+
+  std::ofstream file;
+  if(env.mpirank == 0 && !opts.output.empty())
+    file.open(opts.output.c_str(), std::ios::out | std::ios::app);
+  std::ostream &out = opts.output.empty() ? std::cout : file;
+  out.precision(6);
+
+  LLInt mismatches = 0;
+
+  for(std::size_t i = 0; i < opts.sites.size(); ++i){
+    for(std::size_t j = 0; j < opts.particles.size(); ++j){
+      if(!set_point(env, opts.sites[i], opts.particles[j], opts)){
+        if(env.mpirank == 0) std::cerr << "Skipping L = " << opts.sites[i] << ", N = "
+          << opts.particles[j] << ", not valid for the model" << std::endl;
+        continue;
+      }
+      for(PetscInt r = 0; r < opts.repeats; ++r){
+        if(opts.utils) mismatches += bench_utils(env, opts, out);
+        else bench_point(env, opts, r, out);
+      }
+    }
+  }
+
+  // The check fails the run, so that it can gate the adoption of a new kernel
+  if(mismatches > 0){
+    if(env.mpirank == 0) std::cerr << mismatches << " results of the kernels differ from the "
+      << "reference implementations" << std::endl;
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+
+  return 0;
+}
@@ -0,0 +1,733 @@
+/** @addtogroup Core */
+/** @file */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "../Environment/Environment.h"
+#include "../Utils/Utils.h"
+#include "../Basis/Basis.h"
+#include "../Operators/SparseOp.h"
+#include "../InitialState/InitialState.h"
+#include "../TimeEvo/KrylovEvo.h"
+#include "../TimeEvo/FreeEvo.h"
+#include "../TimeEvo/DrivenEvo.h"
+#include "../Spectral/KPM.h"
+#include "../Spectral/Polfed.h"
+#include "../Output/Results.h"
+
+/// Numerical and output parameters of the time evolution, common to all parameter points.
+struct EvoOptions
+{
+  double initial_time; ///< Initial time of the evolution.
+  double final_time; ///< Final time of the evolution.
+  double tol; ///< Tolerance of the Krylov solver.
+  int maxits; ///< Maximum number of iterations of the Krylov solver.
+  KrylovEvo::Method method; ///< Method of the propagator.
+  PetscInt krylov_dim; ///< Dimension of the Krylov subspace, SLEPc's default if not positive.
+  PetscInt substeps; ///< Substeps of every evolution step.
+  bool autotune; ///< Autotunes the Krylov dimension and the substeps during the first steps.
+  std::vector<PetscInt> tune_dims; ///< Candidate Krylov dimensions of the autotuning.
+  std::vector<PetscInt> tune_substeps; ///< Candidate substeps of the autotuning.
+  bool driven; ///< Periodically driven hopping or potential, see DrivenEvo.
+  double drive_frequency; ///< Angular frequency of the drive.
+  double drive_hopping; ///< Amplitude of the drive of the hopping.
+  double drive_potential; ///< Amplitude of the drive of the potential.
+  PetscInt drive_resolution; ///< Steps per period of the drive.
+  bool neel; ///< Neel initial state instead of a random basis element.
+  bool ground; ///< Ground state of the pre-quench Hamiltonian as initial state.
+  bool typical; ///< Typical (Haar random) initial state, dense in the Hilbert space.
+  ULLInt seed; ///< Seed of the typical initial state.
+  std::vector<std::string> patterns; ///< Product states of the initial superposition, if any.
+  std::vector<PetscScalar> amplitudes; ///< Amplitudes of the product states.
+  bool quench_V_set; ///< Whether the pre-quench interaction strength differs.
+  double quench_V; ///< Pre-quench interaction strength.
+  bool quench_h_set; ///< Whether the pre-quench potential strength differs.
+  double quench_h; ///< Pre-quench strength of the quasi-periodic potential.
+  int steps; ///< Number of evolution steps, the echo is printed after each of them.
+  std::string output_file; ///< HDF5 file of the time series, none if empty.
+  PetscInt snapshot_interval; ///< Steps between snapshots of the state, none if not positive.
+  bool free_evo; ///< Evolve non-interacting systems in the single-particle space.
+  PetscInt kpm_moments; ///< Chebyshev moments of the spectral densities, no time evolution if positive.
+  PetscInt kpm_vectors; ///< Random vectors of the stochastic trace.
+  PetscInt kpm_points; ///< Energies at which the spectral densities are printed.
+  PetscInt polfed_eigenpairs; ///< Eigenpairs per target energy, no time evolution if positive.
+  std::vector<PetscReal> polfed_energies; ///< Target energies, relative to the spectral bounds.
+  PetscInt polfed_order; ///< Order of the filter, from the density of states if not positive.
+  std::string polfed_output; ///< File of the eigenvectors, none if empty.
+};
+
+/** \brief Opens the HDF5 file of the time series of a parameter point, if requested.
+  * \param env The environment.
+  * \param V Interaction strength.
+  * \param t Hopping amplitude.
+  * \param h Strength of the quasi-periodic potential.
+  * \param beta Frequency of the quasi-periodic potential.
+  * \param opts Numerical and output parameters.
+  * \return The writer, to be deleted by the caller, or NULL without -output_file.
+  */
+Results *open_results(Environment &env,
+                      double V,
+                      double t,
+                      double h,
+                      double beta,
+                      const EvoOptions &opts)
+{
+  if(opts.output_file.empty()) return NULL;
+
+  std::vector<PetscReal> parameters(4);
+  parameters[0] = V;
+  parameters[1] = t;
+  parameters[2] = h;
+  parameters[3] = beta;
+  return new Results(env.comm, opts.output_file.c_str(), parameters, "V,t,h,beta");
+}
+
+/** \brief Time evolution of a non-interacting parameter point, see FreeEvo.
+  * \param env The environment.
+  * \param V Interaction strength.
+  * \param t Hopping amplitude.
+  * \param h Strength of the quasi-periodic potential.
+  * \param beta Frequency of the quasi-periodic potential.
+  * \param opts Numerical and output parameters.
+  * \param verbose Prints the initial state and the echo after every step.
+  * \return The Loschmidt echo at the final time.
+  */
+double free_loschmidt_echo(Environment &env,
+                           double V,
+                           double t,
+                           double h,
+                           double beta,
+                           const EvoOptions &opts,
+                           bool verbose)
+{
+  FreeEvo fe(env, t, h, beta);
+  if(opts.neel) fe.neel_initial_state();
+  else fe.random_initial_state(false, verbose);
+
+  double ld = 1.0;
+  if(verbose && env.mpirank == 0){
+    std::cout << "Time"  << "\t" << "Loschmidt echo" << std::endl;
+    std::cout << opts.initial_time << "\t" << ld << std::endl;
+  }
+
+  // Only the time series, the state lives in the single-particle space
+  Results *results = open_results(env, V, t, h, beta, opts);
+  if(results) results->record(opts.initial_time, ld, 0, 0.0);
+
+  double dt = (opts.final_time - opts.initial_time) / opts.steps;
+  for(int step = 0; step < opts.steps; ++step){
+    double wall = MPI_Wtime();
+    ld = fe.loschmidt_echo((step + 1) * dt);
+    if(verbose && env.mpirank == 0){
+      std::cout << opts.initial_time + (step + 1) * dt << "\t" << ld << std::endl;
+    }
+    if(results) results->record(opts.initial_time + (step + 1) * dt, ld, 0, MPI_Wtime() - wall);
+  }
+
+  delete results;
+  return ld;
+}
+
+/** \brief Builds the Hamiltonian and the initial state of a parameter point, within the group.
+  * \param env The environment.
+  * \param V Interaction strength.
+  * \param t Hopping amplitude.
+  * \param h Strength of the quasi-periodic potential.
+  * \param beta Frequency of the quasi-periodic potential.
+  * \param opts Numerical and output parameters.
+  * \param verbose Prints the initial state.
+  * \param aubry The Hamiltonian, to be deleted by the caller.
+  * \param init The initial state in the layout of the Hamiltonian, to be deleted by the caller.
+  */
+void build_problem(Environment &env,
+                   double V,
+                   double t,
+                   double h,
+                   double beta,
+                   const EvoOptions &opts,
+                   bool verbose,
+                   SparseOp *&aubry,
+                   InitialState *&init)
+{
+  // Establish the basis environment, by pointer, to call an early destructor and reclaim
+  // basis memory
+  Basis *basis = new Basis(env);
+
+  // Construct basis
+  basis->construct_int_basis();
+  //basis->print_basis(env);
+
+  // Establish the Hamiltonian operator environment
+  aubry = new SparseOp(env, *basis); 
+
+  // Construct the Hamiltonian matrix, with unit hopping if it is driven so that the hopping
+  // part can be recovered also for t = 0
+  aubry->construct_AA_hamiltonian(basis->int_basis,
+                                  V,
+                                  opts.driven ? 1.0 : t, 
+                                  h,
+                                  beta);
+  // Optionally, reorder the rows of the matrix to reduce communication during MatMult
+  // The parts of a driven Hamiltonian share its pattern and are reordered along with it
+  if(opts.driven) aubry->construct_parts(basis->int_basis);
+  else if(opts.ground) aubry->construct_diagonals(basis->int_basis);
+  if(env.basis_reorder) aubry->reorder_rows();
+
+  // Create an initial state before deleting the basis
+  init = new InitialState(env, *basis);
+  if(opts.neel) init->neel_initial_state();
+  else if(!opts.patterns.empty())
+    init->product_initial_state(opts.patterns, opts.amplitudes, verbose);
+  else if(opts.typical) init->typical_initial_state(opts.seed, verbose);
+  else if(!opts.ground) init->random_initial_state(basis->int_basis, false, verbose);
+  if(env.basis_reorder) init->reorder_rows(aubry->RowOrdering);
+
+  delete basis;
+
+  // Quench: ground state of the pre-quench Hamiltonian, which only differs in the diagonal
+  if(opts.ground){
+    double V0 = opts.quench_V_set ? opts.quench_V : V;
+    double h0 = opts.quench_h_set ? opts.quench_h : h;
+    if(opts.driven){
+      aubry->update_coefficients(V0, t, h0);
+      init->ground_state(aubry->HamMat, verbose);
+    }
+    else{
+      aubry->shift_coefficients(V0 - V, h0 - h);
+      init->ground_state(aubry->HamMat, verbose);
+      aubry->shift_coefficients(V - V0, h - h0);
+    }
+  }
+}
+
+/** \brief Time evolution of a single parameter point, within the group of the process.
+  * \param env The environment.
+  * \param V Interaction strength.
+  * \param t Hopping amplitude.
+  * \param h Strength of the quasi-periodic potential.
+  * \param beta Frequency of the quasi-periodic potential.
+  * \param opts Numerical and output parameters.
+  * \param verbose Prints the initial state and the echo after every step.
+  * \return The Loschmidt echo at the final time.
+  */
+double loschmidt_echo(Environment &env,
+                      double V,
+                      double t,
+                      double h,
+                      double beta,
+                      const EvoOptions &opts,
+                      bool verbose)
+{
+  // A single particle or non-interacting particles are evolved in the single-particle
+  // space, without the basis
+  if(opts.free_evo && !opts.driven && !opts.ground && !opts.typical && opts.patterns.empty() &&
+     env.model == Environment::MODEL_SPINLESS && 
+     (env.n == 1 || V == 0.0))
+    return free_loschmidt_echo(env, V, t, h, beta, opts, verbose);
+
+  PetscMPIInt mpirank = env.mpirank;
+
+  SparseOp *aubry;
+  InitialState *init;
+  build_problem(env, V, t, h, beta, opts, verbose, aubry, init);
+
+  // Time Evo, the Krylov subspace method based on Arnoldi decomposition (or the Chebyshev
+  // expansion) is invoked here
+  KrylovEvo te(aubry->HamMat, opts.tol, opts.maxits, opts.method);
+  te.set_dimensions(opts.krylov_dim, opts.substeps);
+  if(opts.autotune) te.autotune(opts.tune_dims, opts.tune_substeps, verbose);
+  DrivenEvo drive(*aubry, te, V, t, h, opts.drive_hopping, opts.drive_potential,
+                  opts.drive_frequency, opts.drive_resolution);
+
+  // Initial value
+  PetscScalar l_echo;
+  PetscReal ld;
+  Vec t0_vec;
+  VecDuplicate(init->InitialVec, &t0_vec);
+  VecCopy(init->InitialVec, t0_vec);
+  VecDot(t0_vec, init->InitialVec, &l_echo);
+
+  ld = (PetscRealPart(l_echo) * PetscRealPart(l_echo)) + 
+      (PetscImaginaryPart(l_echo) * PetscImaginaryPart(l_echo));
+  if(verbose && mpirank == 0){
+    std::cout << "Time"  << "\t" << "Loschmidt echo" << std::endl;
+    std::cout << opts.initial_time << "\t" << ld << std::endl;
+  }
+
+  Results *results = open_results(env, V, t, h, beta, opts);
+  if(results){
+    results->record(opts.initial_time, ld, 0, 0.0);
+    if(opts.snapshot_interval > 0)
+      results->snapshot(init->InitialVec, opts.initial_time, aubry->RowOrdering);
+  }
+
+  // Time evo, in steps of equal length
+  double dt = (opts.final_time - opts.initial_time) / opts.steps;
+  for(int step = 0; step < opts.steps; ++step){
+    double time = opts.initial_time + (step + 1) * dt;
+    LLInt its = Log::counter_value(Log::COUNTER_KRYLOV_ITS);
+    double wall = MPI_Wtime();
+    if(opts.driven) drive.driven_evo(time, time - dt, init->InitialVec);
+    else te.krylov_evo(time, time - dt, init->InitialVec);
+    VecDot(t0_vec, init->InitialVec, &l_echo);
+    ld = (PetscRealPart(l_echo) * PetscRealPart(l_echo)) + 
+        (PetscImaginaryPart(l_echo) * PetscImaginaryPart(l_echo));
+    if(verbose && mpirank == 0){
+      std::cout << time << "\t" << ld << std::endl;
+    }
+    if(results){
+      results->record(time, ld, Log::counter_value(Log::COUNTER_KRYLOV_ITS) - its, 
+        MPI_Wtime() - wall);
+      if(opts.snapshot_interval > 0 && (step + 1) % opts.snapshot_interval == 0)
+        results->snapshot(init->InitialVec, time, aubry->RowOrdering);
+    }
+  }
+
+  delete results;
+  VecDestroy(&t0_vec);
+  delete init;
+  delete aubry;
+  return ld;
+}
+
+/** \brief Spectral densities of a single parameter point with the kernel polynomial method.
+  * \param env The environment.
+  * \param V Interaction strength.
+  * \param t Hopping amplitude.
+  * \param h Strength of the quasi-periodic potential.
+  * \param beta Frequency of the quasi-periodic potential.
+  * \param opts Numerical and output parameters.
+  *
+  * Prints the density of states per basis element and the local density of states of the
+  * initial state, whose Fourier transform is the return amplitude of the Loschmidt echo.
+  */
+void spectral_density(Environment &env,
+                      double V,
+                      double t,
+                      double h,
+                      double beta,
+                      const EvoOptions &opts)
+{
+  SparseOp *aubry;
+  InitialState *init;
+  build_problem(env, V, t, h, beta, opts, true, aubry, init);
+
+  KPM kpm(aubry->HamMat, opts.kpm_moments);
+
+  std::vector<PetscReal> dos_mu;
+  kpm.dos_moments(opts.kpm_vectors, dos_mu, 0, aubry->RowOrdering);
+
+  std::vector<PetscScalar> ldos_moments;
+  kpm.correlation_moments(init->InitialVec, init->InitialVec, ldos_moments);
+  std::vector<PetscReal> ldos_mu(ldos_moments.size());
+  for(size_t n = 0; n < ldos_moments.size(); ++n) ldos_mu[n] = PetscRealPart(ldos_moments[n]);
+
+  std::vector<PetscReal> energies, dos, ldos;
+  kpm.reconstruct(dos_mu, opts.kpm_points, energies, dos);
+  kpm.reconstruct(ldos_mu, opts.kpm_points, energies, ldos);
+
+  if(env.mpirank == 0){
+    std::cout << "Spectral bounds: " << kpm.e_min << "\t" << kpm.e_max << std::endl;
+    std::cout << "Energy" << "\t" << "DOS" << "\t" << "LDOS" << std::endl;
+    for(size_t k = 0; k < energies.size(); ++k)
+      std::cout << energies[k] << "\t" << dos[k] << "\t" << ldos[k] << std::endl;
+  }
+
+  delete init;
+  delete aubry;
+}
+
+/** \brief Eigenpairs of a single parameter point close to target energies, see Polfed.
+  * \param env The environment.
+  * \param V Interaction strength.
+  * \param t Hopping amplitude.
+  * \param h Strength of the quasi-periodic potential.
+  * \param beta Frequency of the quasi-periodic potential.
+  * \param opts Numerical and output parameters.
+  *
+  * Every target energy is a batch: its eigenvalues and residuals are printed along with the
+  * mean gap ratio, and its eigenvectors are appended to the output file before the next one
+  * is computed. The order of the filter follows from the density of states at the target,
+  * estimated with the kernel polynomial method, unless it is given.
+  */
+void filtered_eigenpairs(Environment &env,
+                         double V,
+                         double t,
+                         double h,
+                         double beta,
+                         const EvoOptions &opts)
+{
+  SparseOp *aubry;
+  InitialState *init;
+  build_problem(env, V, t, h, beta, opts, false, aubry, init);
+  delete init;
+
+  // The density of states only needs to resolve the filter width, a few hundred moments
+  KPM kpm(aubry->HamMat, 256);
+  std::vector<PetscReal> dos_mu;
+  if(opts.polfed_order <= 0) kpm.dos_moments(opts.kpm_vectors, dos_mu, 0, aubry->RowOrdering);
+
+  Polfed polfed(aubry->HamMat, kpm.e_min, kpm.e_max);
+  if(env.mpirank == 0)
+    std::cout << "Spectral bounds: " << kpm.e_min << "\t" << kpm.e_max << std::endl;
+
+  for(size_t b = 0; b < opts.polfed_energies.size(); ++b){
+    PetscReal target = kpm.e_min + opts.polfed_energies[b] * (kpm.e_max - kpm.e_min);
+    PetscInt order = opts.polfed_order;
+    if(order <= 0) order = polfed.filter_order(kpm.density(dos_mu, target), opts.polfed_eigenpairs);
+
+    polfed.solve(target, opts.polfed_eigenpairs, order);
+    if(!opts.polfed_output.empty()) polfed.write_eigenvectors(opts.polfed_output.c_str(), b > 0);
+
+    if(env.mpirank == 0){
+      std::cout << "Target energy: " << target << "\t" << "Filter order: " << order << std::endl;
+      std::cout << "Energy" << "\t" << "Residual" << std::endl;
+      for(size_t k = 0; k < polfed.eigenvalues.size(); ++k)
+        std::cout << polfed.eigenvalues[k] << "\t" << polfed.residuals[k] << std::endl;
+      std::cout << "Mean gap ratio: " << Utils::mean_gap_ratio(polfed.eigenvalues) << std::endl;
+    }
+  }
+
+  delete aubry;
+}
+
+/** \brief Reads a list of parameter points on the first process and broadcasts it.
+  * \param filename Parameter list, one point "V t h beta" per line ('#' for comments).
+  * \param points Parameters of every point, four consecutive values each.
+  */
+void read_param_list(const char *filename,
+                     std::vector<double> &points)
+{
+  PetscMPIInt world_rank;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &world_rank);
+
+  if(world_rank == 0){
+    std::ifstream in(filename);
+    if(!in){
+      std::cerr << "Cannot open the parameter list " << filename << std::endl;
+      MPI_Abort(PETSC_COMM_WORLD, 1);
+    }
+    std::string line;
+    while(std::getline(in, line)){
+      if(line.empty() || line[0] == '#') continue;
+      std::istringstream fields(line);
+      double p[4];
+      if(fields >> p[0] >> p[1] >> p[2] >> p[3]) points.insert(points.end(), p, p + 4);
+    }
+  }
+
+  LLInt n_values = points.size();
+  MPI_Bcast(&n_values, 1, MPI_LONG_LONG, 0, PETSC_COMM_WORLD);
+  points.resize(n_values);
+  if(n_values) MPI_Bcast(&points[0], n_values, MPI_DOUBLE, 0, PETSC_COMM_WORLD);
+}
+
+/** \brief Runs every parameter point of a list, distributed dynamically among the groups.
+  * \param env The environment, split into groups with -groups.
+  * \param points Parameters of every point, four consecutive values (V, t, h, beta) each.
+  * \param opts Numerical and output parameters.
+  *
+  * A shared counter on the first process hands out the next point to the first process
+  * of a group whenever the group becomes idle. The echoes are gathered by the first
+  * process, which prints one line per point in the order of the list.
+  */
+void task_farm(Environment &env,
+               const std::vector<double> &points,
+               const EvoOptions &opts)
+{
+  PetscMPIInt world_rank;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &world_rank);
+
+  LLInt n_points = points.size() / 4;
+
+  // Next point to be handed out, exposed by the first process
+  LLInt next_point = 0;
+  MPI_Win counter;
+  MPI_Win_create(&next_point, (world_rank == 0) ? sizeof(LLInt) : 0, sizeof(LLInt), 
+    MPI_INFO_NULL, PETSC_COMM_WORLD, &counter);
+
+  std::vector<double> echoes(n_points, 0.0);
+  std::vector<LLInt> owners(n_points, 0);
+
+  for(;;){
+    LLInt point;
+    if(env.mpirank == 0){
+      LLInt one = 1;
+      MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, counter);
+      MPI_Fetch_and_op(&one, &point, MPI_LONG_LONG, 0, 0, MPI_SUM, counter);
+      MPI_Win_unlock(0, counter);
+    }
+    MPI_Bcast(&point, 1, MPI_LONG_LONG, 0, env.comm);
+    if(point >= n_points) break;
+
+    const double *p = &points[4 * point];
+    double ld = loschmidt_echo(env, p[0], p[1], p[2], p[3], opts, false);
+    if(env.mpirank == 0){
+      echoes[point] = ld;
+      owners[point] = env.group + 1;
+    }
+  }
+
+  MPI_Win_free(&counter);
+
+  // Every point was computed by a single group
+  if(n_points){
+    if(world_rank == 0){
+      MPI_Reduce(MPI_IN_PLACE, &echoes[0], n_points, MPI_DOUBLE, MPI_SUM, 0, PETSC_COMM_WORLD);
+      MPI_Reduce(MPI_IN_PLACE, &owners[0], n_points, MPI_LONG_LONG, MPI_SUM, 0, 
+        PETSC_COMM_WORLD);
+    }
+    else{
+      MPI_Reduce(&echoes[0], NULL, n_points, MPI_DOUBLE, MPI_SUM, 0, PETSC_COMM_WORLD);
+      MPI_Reduce(&owners[0], NULL, n_points, MPI_LONG_LONG, MPI_SUM, 0, PETSC_COMM_WORLD);
+    }
+  }
+
+  if(world_rank == 0){
+    std::cout << "V" << "\t" << "t" << "\t" << "h" << "\t" << "beta" << "\t" << "Group" 
+      << "\t" << "Loschmidt echo" << std::endl;
+    for(LLInt i = 0; i < n_points; ++i){
+      const double *p = &points[4 * i];
+      std::cout << p[0] << "\t" << p[1] << "\t" << p[2] << "\t" << p[3] << "\t"
+        << owners[i] - 1 << "\t" << echoes[i] << std::endl;
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  // Default system, can be changed with -l and -n
+  unsigned int l = 55;
+  unsigned int n = 1;
+
+  // Establish the environment
+  Environment env(argc, argv, l, n);
+
+  // Optionally, only predict the memory requirements, before allocating anything
+  if(env.memory_preflight){
+    env.memory_report();
+    return 0;
+  }
+
+  // Numerical and output parameters
+  EvoOptions opts;
+  opts.initial_time = 0.0;
+  opts.final_time = 10.0;
+  opts.tol = 1.0e-7;
+  PetscInt maxits = 1000000;
+  PetscInt steps = 1;
+  PetscOptionsGetReal(NULL, NULL, "-initial_time", &opts.initial_time, NULL);
+  PetscOptionsGetReal(NULL, NULL, "-final_time", &opts.final_time, NULL);
+  PetscOptionsGetReal(NULL, NULL, "-krylov_tol", &opts.tol, NULL);
+  PetscOptionsGetInt(NULL, NULL, "-krylov_maxits", &maxits, NULL);
+  PetscOptionsGetInt(NULL, NULL, "-output_steps", &steps, NULL);
+  opts.maxits = maxits;
+  opts.steps = (steps > 0) ? steps : 1;
+
+  // Time series and snapshots of the state in an HDF5 file, written collectively
+  {
+    char output[PETSC_MAX_PATH_LEN];
+    PetscBool flg;
+    PetscOptionsGetString(NULL, NULL, "-output_file", output, PETSC_MAX_PATH_LEN, &flg);
+    if(flg) opts.output_file = output;
+    opts.snapshot_interval = 0;
+    PetscOptionsGetInt(NULL, NULL, "-output_snapshots", &opts.snapshot_interval, NULL);
+  }
+
+  const char *methods[] = {"expokit", "chebyshev"};
+  PetscInt method = 0;
+  PetscOptionsGetEList(NULL, NULL, "-evo_method", methods, 2, &method, NULL);
+  opts.method = (method == 1) ? KrylovEvo::METHOD_CHEBYSHEV : KrylovEvo::METHOD_EXPOKIT;
+
+  // Krylov dimension and substeps, fixed or autotuned over the given candidates
+  opts.krylov_dim = 0;
+  opts.substeps = 1;
+  PetscOptionsGetInt(NULL, NULL, "-mfn_ncv", &opts.krylov_dim, NULL);
+  PetscOptionsGetInt(NULL, NULL, "-krylov_substeps", &opts.substeps, NULL);
+
+  PetscBool autotune = PETSC_FALSE;
+  PetscOptionsGetBool(NULL, NULL, "-krylov_autotune", &autotune, NULL);
+  opts.autotune = autotune;
+
+  const char *tune_names[2] = {"-krylov_autotune_dims", "-krylov_autotune_substeps"};
+  const PetscInt tune_defaults[2][3] = {{16, 32, 64}, {1, 2, 4}};
+  std::vector<PetscInt> *tune_values[2] = {&opts.tune_dims, &opts.tune_substeps};
+  for(int i = 0; i < 2; ++i){
+    PetscInt count = 64;
+    PetscBool flg;
+    tune_values[i]->resize(count);
+    PetscOptionsGetIntArray(NULL, NULL, tune_names[i], &(*tune_values[i])[0], &count, &flg);
+    if(flg) tune_values[i]->resize(count);
+    else tune_values[i]->assign(tune_defaults[i], tune_defaults[i] + 3);
+  }
+
+  const char *states[] = {"random", "neel", "ground", "typical", "product"};
+  PetscInt state = 0;
+  PetscOptionsGetEList(NULL, NULL, "-initial_state", states, 5, &state, NULL);
+  opts.neel = (state == 1);
+  opts.ground = (state == 2);
+  opts.typical = (state == 3);
+
+  // Superposition of product states, e.g. -initial_patterns 1010,0101 -initial_amplitudes 1,-1
+  if(state == 4){
+    PetscInt count = 256;
+    PetscBool flg;
+    char *patterns[256];
+    PetscOptionsGetStringArray(NULL, NULL, "-initial_patterns", patterns, &count, &flg);
+    if(!flg || count == 0){
+      if(env.mpirank == 0) std::cerr << "-initial_state product requires -initial_patterns" 
+        << std::endl;
+      MPI_Abort(PETSC_COMM_WORLD, 1);
+    }
+    for(PetscInt k = 0; k < count; ++k){
+      opts.patterns.push_back(patterns[k]);
+      PetscFree(patterns[k]);
+    }
+
+    PetscInt n_amplitudes = count;
+    opts.amplitudes.assign(count, 1.0);
+    PetscOptionsGetScalarArray(NULL, NULL, "-initial_amplitudes", &opts.amplitudes[0], 
+      &n_amplitudes, &flg);
+    if(flg && n_amplitudes != count){
+      if(env.mpirank == 0) std::cerr << "-initial_amplitudes requires one amplitude per pattern" 
+        << std::endl;
+      MPI_Abort(PETSC_COMM_WORLD, 1);
+    }
+  }
+
+  PetscInt seed = 0;
+  PetscOptionsGetInt(NULL, NULL, "-initial_seed", &seed, NULL);
+  opts.seed = seed;
+
+  PetscBool quench_V_set, quench_h_set;
+  opts.quench_V = opts.quench_h = 0.0;
+  PetscOptionsGetReal(NULL, NULL, "-quench_interaction", &opts.quench_V, &quench_V_set);
+  PetscOptionsGetReal(NULL, NULL, "-quench_potential", &opts.quench_h, &quench_h_set);
+  opts.quench_V_set = quench_V_set;
+  opts.quench_h_set = quench_h_set;
+
+  PetscBool free_evo = PETSC_TRUE;
+  PetscOptionsGetBool(NULL, NULL, "-free_evo", &free_evo, NULL);
+  opts.free_evo = free_evo;
+
+  opts.kpm_moments = 0;
+  opts.kpm_vectors = 10;
+  PetscOptionsGetInt(NULL, NULL, "-kpm_moments", &opts.kpm_moments, NULL);
+  PetscOptionsGetInt(NULL, NULL, "-kpm_vectors", &opts.kpm_vectors, NULL);
+  opts.kpm_points = 2 * opts.kpm_moments;
+  PetscOptionsGetInt(NULL, NULL, "-kpm_points", &opts.kpm_points, NULL);
+
+  // Eigenpairs around target energies, in the middle of the spectrum by default
+  opts.polfed_eigenpairs = 0;
+  opts.polfed_order = 0;
+  PetscOptionsGetInt(NULL, NULL, "-polfed_eigenpairs", &opts.polfed_eigenpairs, NULL);
+  PetscOptionsGetInt(NULL, NULL, "-polfed_order", &opts.polfed_order, NULL);
+  {
+    PetscInt count = 256;
+    PetscBool flg;
+    opts.polfed_energies.resize(count);
+    PetscOptionsGetRealArray(NULL, NULL, "-polfed_energy", &opts.polfed_energies[0], &count, &flg);
+    if(flg) opts.polfed_energies.resize(count);
+    else opts.polfed_energies.assign(1, 0.5);
+
+    char output[PETSC_MAX_PATH_LEN];
+    PetscOptionsGetString(NULL, NULL, "-polfed_output", output, PETSC_MAX_PATH_LEN, &flg);
+    if(flg) opts.polfed_output = output;
+  }
+
+  // Periodic drive of the hopping and of the potential, t + a_t cos(w s) and h + a_h cos(w s)
+  opts.drive_frequency = 0.0;
+  opts.drive_hopping = 0.0;
+  opts.drive_potential = 0.0;
+  opts.drive_resolution = 20;
+  PetscOptionsGetReal(NULL, NULL, "-drive_frequency", &opts.drive_frequency, NULL);
+  PetscOptionsGetReal(NULL, NULL, "-drive_hopping", &opts.drive_hopping, NULL);
+  PetscOptionsGetReal(NULL, NULL, "-drive_potential", &opts.drive_potential, NULL);
+  PetscOptionsGetInt(NULL, NULL, "-drive_resolution", &opts.drive_resolution, NULL);
+  opts.driven = (opts.drive_hopping != 0.0 || opts.drive_potential != 0.0);
+
+  // The Chebyshev expansion keeps the spectral bounds of the static Hamiltonian
+  if(opts.driven && opts.method == KrylovEvo::METHOD_CHEBYSHEV){
+    if(env.mpirank == 0) std::cerr << "A driven Hamiltonian requires -evo_method expokit" 
+      << std::endl;
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+
+  // Parameter points, either from a file or from the combinations of the value lists 
+  // given to -interaction (V), -hopping (t), -potential (h) and -beta
+  std::vector<double> points;
+  char param_list[PETSC_MAX_PATH_LEN];
+  PetscBool from_file;
+  PetscOptionsGetString(NULL, NULL, "-param_list", param_list, PETSC_MAX_PATH_LEN, 
+    &from_file);
+
+  if(from_file){
+    read_param_list(param_list, points);
+  }
+  else{
+    const char *names[4] = {"-interaction", "-hopping", "-potential", "-beta"};
+    PetscReal defaults[4] = {1.0, 0.5, 1.0, 34.0 / 55.0};
+    std::vector<std::vector<PetscReal> > values(4);
+    
+    for(int i = 0; i < 4; ++i){
+      PetscInt count = 256;
+      PetscBool flg;
+      values[i].resize(count);
+      PetscOptionsGetRealArray(NULL, NULL, names[i], &values[i][0], &count, &flg);
+      if(flg) values[i].resize(count);
+      else values[i].assign(1, defaults[i]);
+    }
+  
+    for(size_t iv = 0; iv < values[0].size(); ++iv)
+      for(size_t it = 0; it < values[1].size(); ++it)
+        for(size_t ih = 0; ih < values[2].size(); ++ih)
+          for(size_t ib = 0; ib < values[3].size(); ++ib){
+            points.push_back(values[0][iv]);
+            points.push_back(values[1][it]);
+            points.push_back(values[2][ih]);
+            points.push_back(values[3][ib]);
+          }
+  }
+
+  // Eigenpairs or spectral densities instead of the time evolution, for a single point
+  if(opts.polfed_eigenpairs > 0){
+    if(points.size() != 4 || env.n_groups != 1){
+      if(env.mpirank == 0) std::cerr << "-polfed_eigenpairs requires a single parameter point" 
+        << " and a single group" << std::endl;
+      MPI_Abort(PETSC_COMM_WORLD, 1);
+    }
+    if(opts.driven){
+      if(env.mpirank == 0) std::cerr << "-polfed_eigenpairs requires a static Hamiltonian" 
+        << std::endl;
+      MPI_Abort(PETSC_COMM_WORLD, 1);
+    }
+    filtered_eigenpairs(env, points[0], points[1], points[2], points[3], opts);
+  }
+  else if(opts.kpm_moments > 0){
+    if(points.size() != 4 || env.n_groups != 1){
+      if(env.mpirank == 0) std::cerr << "-kpm_moments requires a single parameter point" 
+        << " and a single group" << std::endl;
+      MPI_Abort(PETSC_COMM_WORLD, 1);
+    }
+    if(opts.driven){
+      if(env.mpirank == 0) std::cerr << "-kpm_moments requires a static Hamiltonian" << std::endl;
+      MPI_Abort(PETSC_COMM_WORLD, 1);
+    }
+    spectral_density(env, points[0], points[1], points[2], points[3], opts);
+  }
+  // A single point in a single group prints its whole evolution
+  else if(points.size() == 4 && env.n_groups == 1)
+    loschmidt_echo(env, points[0], points[1], points[2], points[3], opts, true);
+  else{
+    if(!opts.output_file.empty()){
+      if(env.mpirank == 0) std::cerr << "-output_file requires a single parameter point" 
+        << " and a single group" << std::endl;
+      MPI_Abort(PETSC_COMM_WORLD, 1);
+    }
+    task_farm(env, points, opts);
+  }
+
+  return 0;
+}
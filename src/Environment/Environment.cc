@@ -0,0 +1,352 @@
+#include "Environment.h"
+
+#include <unistd.h>
+
+#include "../Utils/Utils.h"
+#include "../Basis/Sector.h"
+#include "../Log/Log.h"
+
+namespace
+{
+  // Names of the lookup policies, in the order of Environment::LookupPolicy
+  const char *approach_names[] = {"NodeComm", "RingComm", "SharedWindow", "Ranking"};
+}
+
+Environment::Environment(int argc, char **argv, unsigned int l, unsigned int n)
+: l(l), n(n)
+{
+  SlepcInitialize(&argc, &argv, NULL, NULL);
+  Log::register_phases();
+
+  // The world is split into -groups contiguous groups of processes, each of them working
+  // on its own problem. All the objects of the application live in the group's comm
+  PetscMPIInt world_rank, world_size;
+  MPI_Comm_size(PETSC_COMM_WORLD, &world_size);
+  MPI_Comm_rank(PETSC_COMM_WORLD, &world_rank);
+
+  PetscInt groups = 1;
+  PetscOptionsGetInt(NULL, NULL, "-groups", &groups, NULL);
+  if(groups < 1 || groups > world_size){
+    if(world_rank == 0)
+      std::cerr << "The number of groups must be between 1 and the number of processes" 
+        << std::endl;
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+  n_groups = groups;
+  group = (static_cast<LLInt> (world_rank) * n_groups) / world_size;
+
+  MPI_Comm_split(PETSC_COMM_WORLD, group, world_rank, &comm);
+
+  MPI_Comm_size(comm, &mpisize);
+  MPI_Comm_rank(comm, &mpirank);
+
+  MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, mpirank, MPI_INFO_NULL,
+    &node_comm);
+
+  MPI_Comm_size(node_comm, &node_size);
+  MPI_Comm_rank(node_comm, &node_rank);
+
+  // The arguments are defaults, the size of the system can be given at runtime
+  PetscInt size;
+  PetscBool flg;
+  PetscOptionsGetInt(NULL, NULL, "-l", &size, &flg);
+  if(flg) this->l = size;
+  PetscOptionsGetInt(NULL, NULL, "-n", &size, &flg);
+  if(flg) this->n = size;
+  n_down = n;
+  PetscOptionsGetInt(NULL, NULL, "-n_down", &size, &flg);
+  if(flg) this->n_down = size;
+  max_occupation = n;
+  PetscOptionsGetInt(NULL, NULL, "-max_occupation", &size, &flg);
+  if(flg) this->max_occupation = size;
+
+  const char *models[] = {"spinless", "hubbard", "bose_hubbard"};
+  PetscInt kind = MODEL_SPINLESS;
+  PetscOptionsGetEList(NULL, NULL, "-model", models, 3, &kind, NULL);
+  model = static_cast<Model> (kind);
+
+  const char *kinds[] = {"bosons", "fermions"};
+  kind = HARDCORE_BOSONS;
+  PetscOptionsGetEList(NULL, NULL, "-statistics", kinds, 2, &kind, NULL);
+  statistics = static_cast<Statistics> (kind);
+
+  if(model != MODEL_BOSE_HUBBARD && (this->n > this->l || this->n_down > this->l)){
+    if(mpirank == 0) std::cerr << "The number of particles exceeds the number of sites" 
+      << std::endl;
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+  if(model == MODEL_BOSE_HUBBARD && (this->max_occupation == 0 
+    || this->n > static_cast<ULLInt> (this->l) * this->max_occupation)){
+    if(mpirank == 0) std::cerr << "The number of particles exceeds the capacity of the sites" 
+      << std::endl;
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+
+  PetscOptionsHasName(NULL, NULL, "-nnz_balance", &nnz_balance);
+  PetscOptionsHasName(NULL, NULL, "-basis_reorder", &basis_reorder);
+  assembly_buffer_mb = -1.0;
+  PetscOptionsGetReal(NULL, NULL, "-assembly_buffer_mb", &assembly_buffer_mb, NULL);
+
+  PetscOptionsHasName(NULL, NULL, "-memory_preflight", &memory_preflight);
+  memory_per_node_mb = static_cast<double> (sysconf(_SC_PHYS_PAGES))
+    * sysconf(_SC_PAGE_SIZE) / (1024.0 * 1024.0);
+  PetscOptionsGetReal(NULL, NULL, "-memory_per_node_mb", &memory_per_node_mb, NULL);
+
+  // Every executable defaults to the approach it is named after, see the Makefiles
+  const char *policies[] = {"node", "ring", "window", "rank", "auto"};
+#ifdef APPROACH_RING
+  PetscInt policy = LOOKUP_RING;
+#else
+  PetscInt policy = LOOKUP_NODE;
+#endif
+  PetscOptionsGetEList(NULL, NULL, "-lookup_policy", policies, 5, &policy, NULL);
+  if(policy > LOOKUP_RANK){
+    lookup_policy = select_lookup_policy_();
+    if(mpirank == 0) std::cout << "Lookup policy selected by memory: " << approach() 
+      << std::endl;
+  }
+  else lookup_policy = static_cast<LookupPolicy> (policy);
+}
+
+Environment::~Environment()
+{
+  char summary[PETSC_MAX_PATH_LEN];
+  PetscBool flg;
+  PetscOptionsGetString(NULL, NULL, "-phase_summary", summary, PETSC_MAX_PATH_LEN, &flg);
+  if(flg) Log::write_summary(summary, approach());
+
+  MPI_Comm_free(&node_comm);
+  MPI_Comm_free(&comm);
+  SlepcFinalize();
+}
+
+/*******************************************************************************/
+// The dimension depends on the model, see Sector
+/*******************************************************************************/
+LLInt Environment::basis_size() const 
+{
+  return Sector(*this).size();
+}
+
+/*******************************************************************************/
+// Determines the distribution among processes without relying on PETSc routines
+// This is done to avoid allocation of PETSc objects before they are required,
+// therefore saving memory
+/*******************************************************************************/
+void Environment::distribution(PetscInt b_size, 
+                               PetscInt &nlocal, 
+                               PetscInt &start, 
+                               PetscInt &end) const
+{
+  nlocal = b_size / mpisize;
+  PetscInt rest = b_size % mpisize;
+
+  if(rest && (mpirank < rest)) nlocal++;
+
+  start = mpirank * nlocal;
+  if(rest && (mpirank >= rest)) start += rest;
+
+  end = start + nlocal;
+}
+
+/*******************************************************************************/
+// Row ranges are chosen such that the estimated amount of non-zero entries is
+// the same for each process. Boundary k is the first row for which the 
+// accumulated work (entries in all previous rows) reaches k * total / mpisize. 
+// The work of evaluating the estimate is itself shared using the equal
+// distribution, each process finds the boundaries that fall in its section
+/*******************************************************************************/
+void Environment::nnz_distribution(PetscInt b_size, 
+                                   PetscInt &nlocal, 
+                                   PetscInt &start, 
+                                   PetscInt &end) const
+{
+  Log::stage_push(Log::STAGE_BASIS);
+  Log::event_begin(Log::EVENT_DISTRIBUTION);
+
+  PetscInt eq_nlocal, eq_start, eq_end;
+  distribution(b_size, eq_nlocal, eq_start, eq_end);
+
+  Sector sector(*this);
+  State first = sector.unrank(eq_start);
+
+  State state = first;
+  LLInt work_local = 0;
+  for(PetscInt i = eq_start; i < eq_end; ++i){
+    work_local += sector.row_nnz(state);
+    if(i + 1 < eq_end) state = sector.next(state);
+  }
+
+  LLInt work_offset = 0;
+  LLInt work_total, work_max_eq;
+  MPI_Exscan(&work_local, &work_offset, 1, MPI_LONG_LONG, MPI_SUM, comm);
+  if(mpirank == 0) work_offset = 0;
+  MPI_Allreduce(&work_local, &work_total, 1, MPI_LONG_LONG, MPI_SUM, comm);
+  MPI_Allreduce(&work_local, &work_max_eq, 1, MPI_LONG_LONG, MPI_MAX, comm);
+
+  // bounds[k] is the first row of process k, work[k] is the accumulated work up to it.
+  // Process owns the targets in (work_offset, work_offset + work_local]
+  std::vector<LLInt> bounds(mpisize + 1, 0);
+  std::vector<LLInt> work(mpisize + 1, 0);
+  double target = static_cast<double>(work_total) / mpisize;
+
+  PetscMPIInt k = 1;
+  while(k < mpisize && k * target <= work_offset) ++k;
+
+  state = first;
+  LLInt acc = work_offset;
+  for(PetscInt i = eq_start; i < eq_end && k < mpisize; ++i){
+    acc += sector.row_nnz(state);
+    while(k < mpisize && k * target <= acc){
+      bounds[k] = i + 1;
+      work[k] = acc;
+      ++k;
+    }
+    if(i + 1 < eq_end) state = sector.next(state);
+  }
+  
+  MPI_Allreduce(MPI_IN_PLACE, &bounds[0], mpisize + 1, MPI_LONG_LONG, MPI_MAX, comm);
+  MPI_Allreduce(MPI_IN_PLACE, &work[0], mpisize + 1, MPI_LONG_LONG, MPI_MAX, comm);
+  bounds[mpisize] = b_size;
+  work[mpisize] = work_total;
+
+  start = bounds[mpirank];
+  end = bounds[mpirank + 1];
+  nlocal = end - start;
+
+  if(mpirank == 0){
+    LLInt work_max = 0;
+    for(PetscMPIInt p = 0; p < mpisize; ++p)
+      work_max = std::max(work_max, work[p + 1] - work[p]);
+
+    std::cout << "Non-zero balanced distribution, estimated entries: " << work_total 
+      << std::endl;
+    std::cout << "Imbalance (max/avg) with equal rows: " << work_max_eq / target
+      << ", with balanced rows: " << work_max / target << std::endl;
+  }
+
+  Log::event_end(Log::EVENT_DISTRIBUTION);
+  Log::stage_pop();
+}
+
+/*******************************************************************************/
+// The autotuning tries every candidate dimension, the largest sets the peak
+/*******************************************************************************/
+PetscInt Environment::krylov_dimension_() const
+{
+  PetscInt krylov_dim = 30;
+  PetscOptionsGetInt(NULL, NULL, "-mfn_ncv", &krylov_dim, NULL);
+
+  PetscBool autotune = PETSC_FALSE;
+  PetscOptionsGetBool(NULL, NULL, "-krylov_autotune", &autotune, NULL);
+  if(autotune){
+    PetscInt dims[64] = {16, 32, 64};
+    PetscInt count = 64;
+    PetscBool flg;
+    PetscOptionsGetIntArray(NULL, NULL, "-krylov_autotune_dims", dims, &count, &flg);
+    if(!flg) count = 3;
+    for(PetscInt i = 0; i < count; ++i) krylov_dim = std::max(krylov_dim, dims[i]);
+  }
+
+  return krylov_dim;
+}
+
+/*******************************************************************************/
+// Per node, the node and window policies have one leader holding the full basis
+// and the rest are workers, while all the processes are equal for the others
+/*******************************************************************************/
+double Environment::node_memory(LookupPolicy policy, 
+                                PetscMPIInt ppn, 
+                                PetscMPIInt nodes) const
+{
+  Sector sector(*this);
+  double b_size = static_cast<double> (sector.size());
+  double hops = sector.average_hops();
+  PetscInt krylov_dim = krylov_dimension_();
+
+  double leader = Utils::predict_memory(policy, b_size, hops, nodes * ppn, krylov_dim, true);
+  double worker = Utils::predict_memory(policy, b_size, hops, nodes * ppn, krylov_dim, false);
+
+  return leader + (ppn - 1) * worker;
+}
+
+const char *Environment::approach() const
+{
+  return approach_names[lookup_policy];
+}
+
+/*******************************************************************************/
+// The shared window needs no communication at all during the construction, and
+// ranking holds the least elements. Every process takes the same decision, from
+// the smallest memory of a node and the largest number of processes per node
+/*******************************************************************************/
+Environment::LookupPolicy Environment::select_lookup_policy_() const
+{
+  PetscMPIInt leader = (node_rank == 0), size = node_size, nodes, ppn;
+  double memory = memory_per_node_mb, budget;
+  MPI_Allreduce(&leader, &nodes, 1, MPI_INT, MPI_SUM, comm);
+  MPI_Allreduce(&size, &ppn, 1, MPI_INT, MPI_MAX, comm);
+  MPI_Allreduce(&memory, &budget, 1, MPI_DOUBLE, MPI_MIN, comm);
+
+  if(node_memory(LOOKUP_WINDOW, ppn, nodes) / (1024.0 * 1024.0) <= budget) return LOOKUP_WINDOW;
+  return LOOKUP_RANK;
+}
+
+/*******************************************************************************/
+// Only the first process reports. The leader and workers of the node policy are
+// also given on their own
+/*******************************************************************************/
+void Environment::memory_report() const
+{
+  PetscInt krylov_dim = krylov_dimension_();
+
+  if(mpirank != 0) return;
+
+  const double mb = 1024.0 * 1024.0;
+  Sector sector(*this);
+  double b_size = static_cast<double> (sector.size());
+  double hops = sector.average_hops();
+  PetscMPIInt nodes = mpisize / node_size;
+  if(nodes * node_size < mpisize) ++nodes;
+
+  std::cout << "Predicted peak memory (MB), l = " << l << ", n = " << n << ", " << nodes
+    << " node(s), Krylov dimension " << krylov_dim << ", " << memory_per_node_mb
+    << " MB per node" << std::endl;
+  std::cout << "ranks/node\tranks\tNodeComm leader\tNodeComm worker\tNodeComm node"
+    << "\tRingComm node\tSharedWindow node\tRanking node" << std::endl;
+
+  PetscMPIInt best_ppn = 0;
+  double best_node = 0.0;
+  const char *best_approach = NULL;
+  std::vector<PetscMPIInt> layouts;
+  for(PetscMPIInt ppn = 1; ppn < node_size; ppn *= 2) layouts.push_back(ppn);
+  layouts.push_back(node_size);
+
+  for(size_t i = 0; i < layouts.size(); ++i){
+    PetscMPIInt ppn = layouts[i];
+    PetscMPIInt ranks = nodes * ppn;
+
+    double leader = Utils::predict_memory(LOOKUP_NODE, b_size, hops, ranks, krylov_dim, true);
+    double worker = Utils::predict_memory(LOOKUP_NODE, b_size, hops, ranks, krylov_dim, false);
+    std::cout << ppn << "\t\t" << ranks << "\t" << leader / mb << "\t\t" << worker / mb;
+
+    // Prefer more processes, then less memory
+    for(int k = LOOKUP_NODE; k <= LOOKUP_RANK; ++k){
+      double node = node_memory(static_cast<LookupPolicy> (k), ppn, nodes) / mb;
+      std::cout << "\t\t" << node;
+      if(node <= memory_per_node_mb && (ppn > best_ppn || node < best_node)){
+        best_ppn = ppn;
+        best_node = node;
+        best_approach = approach_names[k];
+      }
+    }
+    std::cout << std::endl;
+  }
+
+  if(best_approach)
+    std::cout << "Recommended: " << best_approach << " with " << best_ppn
+      << " process(es) per node, " << best_node << " MB per node" << std::endl;
+  else
+    std::cout << "No layout fits in " << memory_per_node_mb << " MB per node, more nodes "
+      << "are required" << std::endl;
+}
@@ -0,0 +1,150 @@
+/** @addtogroup Core
+ * @{
+ */
+/**
+ * \class Environment.
+ * \ingroup Core
+ * \brief Initializes the MPI, PETSc and SLEPc environments.
+ *
+ * This class should be instantiated at the beginning of the program and at the end
+ * of execution the environment will close automatically
+ * Refer to Section 3 of the manuscript in /docs.
+ * The lookup policy decides which basis elements every process holds besides its own
+ * section, and how the global index of the others is found (see LookupPolicy).
+ */
+#ifndef __ENVIRONMENT_H
+#define __ENVIRONMENT_H
+
+#include <iostream>
+#include <vector>
+#include <stdint.h>
+
+#include <petscsys.h>
+#include <slepcmfn.h>
+#include <slepceps.h>
+
+typedef unsigned long long ULLInt;
+typedef PetscInt LLInt;
+
+class Environment
+{
+  public:
+    /// Strategies to find the global index of the basis elements that are not held locally.
+    enum LookupPolicy { LOOKUP_NODE, ///< The first process of every node holds the full basis and
+                                     ///< answers the requests of the others (NodeComm).
+                        LOOKUP_RING, ///< The sections are passed around a ring of all the
+                                     ///< processes (RingComm).
+                        LOOKUP_WINDOW, ///< The full basis is held once per node in shared memory
+                                       ///< and searched directly by every process of the node.
+                        LOOKUP_RANK ///< Compute the index directly, see Sector::rank().
+                      };
+    /// Exchange statistics of the particles, which fixes the sign of every hop.
+    enum Statistics { HARDCORE_BOSONS, ///< All hops are +t (default).
+                      FERMIONS ///< Spinless fermions, see Utils::hop_sign().
+                    };
+    /// Hamiltonian of the chain, see Sector for the encoding of every one.
+    enum Model { MODEL_SPINLESS, ///< Single species with nearest-neighbour interaction V (default).
+                 MODEL_HUBBARD, ///< Two species (n up, n_down down) with on-site interaction V.
+                 MODEL_BOSE_HUBBARD ///< Soft-core bosons, at most max_occupation per site, on-site V.
+               };
+    /** \brief Creates an instance of class Environment.
+      * \param argc Required to parse PETSc/SLEPc's options.
+      * \param argv Required to parse PETSc/SLEPc's options.
+      * \param l Number of sites, unless given by the runtime option -l.
+      * \param n Subspace descriptor (number of particles), unless given by the runtime option -n.
+      *
+      * This is the only available constructor of this class. This constructor is used to 
+      * initialise PETSc, SLEPc and MPI environments and should be instantiated at the 
+      * beginning of the program.
+      */
+    Environment(int argc, 
+                char **argv, 
+                unsigned int l, 
+                unsigned int n);
+    /** \brief Destructor.
+      * 
+      * Writes the phase summary if -phase_summary <file> is given (see Log), then
+      * closes the MPI, PETSc and SLEPc environment. Destroys the group and node
+      * communicators.
+      */
+    ~Environment();
+    /** \brief Computes the dimension of the Hilbert space, see Sector::size().
+      */
+    LLInt basis_size() const;
+    /** \brief Computes the section and global indices of locally owned elements.
+      * \param b_size Dimension of the Hilbert space.
+      * \param nlocal Local section of the process (amount of elements/number of rows).
+      * \param start Global index refering to the local process.
+      * \param end Global index refering to the local process.
+      * 
+      * This parallel distribution agrees with PETSc's row-wise distribution
+      * Refer to Algorithm 1 of the manuscript in /docs.
+      */
+    void distribution(PetscInt b_size, 
+                      PetscInt &nlocal, 
+                      PetscInt &start, 
+                      PetscInt &end) const;
+    /** \brief Computes a row-wise distribution balanced by the number of non-zero entries.
+      * \param b_size Dimension of the Hilbert space.
+      * \param nlocal Local section of the process (amount of elements/number of rows).
+      * \param start Global index refering to the local process.
+      * \param end Global index refering to the local process.
+      * 
+      * Contiguous row ranges are assigned so that every process holds roughly the same
+      * amount of estimated non-zero entries (see Utils::row_nnz_estimate()), instead of the
+      * same amount of rows. The estimate is evaluated in parallel over the equal row
+      * distribution, and the resulting imbalance (maximum over average work) is reported
+      * to stdout for both distributions. Enabled with the runtime option -nnz_balance.
+      */
+    void nnz_distribution(PetscInt b_size, 
+                          PetscInt &nlocal, 
+                          PetscInt &start, 
+                          PetscInt &end) const;
+    /** \brief Reports the predicted peak memory of every lookup policy, without allocating anything.
+      *
+      * Collective. For the current number of nodes, every number of processes per node (powers of two
+      * up to the current one) is evaluated with Utils::predict_memory(), using the
+      * Krylov dimension given by -mfn_ncv (30 by default). The largest layout that fits in
+      * -memory_per_node_mb (physical memory of the node by default) is recommended.
+      * Enabled with the runtime option -memory_preflight, the program exits afterwards.
+      */
+    void memory_report() const;
+    /** \brief Predicts the peak memory of a node, see Utils::predict_memory().
+      * \param policy Lookup policy.
+      * \param ppn Number of processes per node.
+      * \param nodes Number of nodes.
+      * \return Predicted peak, in bytes.
+      */
+    double node_memory(LookupPolicy policy,
+                       PetscMPIInt ppn,
+                       PetscMPIInt nodes) const;
+    /// Name of the selected lookup policy, as written in the summaries.
+    const char *approach() const;
+    unsigned int l; ///< Number of sites.
+    unsigned int n; ///< Subspace descriptor (number of particles).
+    unsigned int n_down; ///< Number of down particles of the Hubbard model (n by default).
+    unsigned int max_occupation; ///< Largest occupation of a site of the Bose-Hubbard model (n by default).
+    Model model; ///< Selected with -model <spinless|hubbard|bose_hubbard>.
+    MPI_Comm comm; ///< Communicator of the group of the process, see -groups.
+    PetscMPIInt group; ///< Index of the group of the process.
+    PetscMPIInt n_groups; ///< Number of groups, each one working on its own problem.
+    PetscMPIInt mpirank; ///< Index of the local processor (within the group).
+    PetscMPIInt mpisize; ///< Total number of processors (within the group).
+    PetscMPIInt node_rank; ///< Rank respective to the node
+    PetscMPIInt node_size; ///< Number of processes per node
+    MPI_Comm node_comm; ///< The MPI communicator respective of the node
+    PetscBool nnz_balance; ///< If true, rows are distributed by nnz_distribution().
+    PetscBool basis_reorder; ///< If true, rows are reordered to minimise communication.
+    PetscReal assembly_buffer_mb; ///< Memory budget (MB) of the assembly staging buffer, negative if unlimited.
+    LookupPolicy lookup_policy; ///< Selected with -lookup_policy <node|ring|window|rank|auto>.
+    Statistics statistics; ///< Selected with -statistics <bosons|fermions>.
+    PetscBool memory_preflight; ///< If true, only memory_report() is executed.
+    PetscReal memory_per_node_mb; ///< Memory (MB) available per node, for memory_report().
+  private:
+    /// Largest Krylov dimension of the time evolution, for the memory predictions.
+    PetscInt krylov_dimension_() const;
+    /// Lookup policy of -lookup_policy auto, the shared window if it fits in memory.
+    LookupPolicy select_lookup_policy_() const;
+};
+#endif
+/** @}*/
@@ -0,0 +1,295 @@
+#include "InitialState.h"
+
+/*******************************************************************************/
+// Single custom constructor for this class.
+// Creates the initial state object.
+/*******************************************************************************/
+InitialState::InitialState(const Environment &env,
+                           const Basis &basis) : sector_(basis.sector)
+{
+  l_ = env.l;
+  n_ = env.n;
+  mpirank_ = env.mpirank;
+  mpisize_ = env.mpisize;
+  comm_ = env.comm;
+  nlocal_ = basis.nlocal;
+  start_ = basis.start;
+  end_ = basis.end;
+  basis_size_ = basis.basis_size;
+  basis_start_ = basis.basis_start;
+
+  VecCreateMPI(comm_, nlocal_, basis_size_, &InitialVec);
+}
+
+/*******************************************************************************/
+// Copy constructor
+/*******************************************************************************/
+InitialState::InitialState(const InitialState &rhs) : sector_(rhs.sector_)
+{
+  std::cout << "Copy constructor (initial state) has been called!" << std::endl;
+
+  l_ = rhs.l_;
+  n_ = rhs.n_;
+  mpirank_ = rhs.mpirank_;
+  mpisize_ = rhs.mpisize_;
+  comm_ = rhs.comm_;
+  nlocal_ = rhs.nlocal_;
+  start_ = rhs.start_;
+  end_ = rhs.end_;
+  basis_size_ = rhs.basis_size_;
+  basis_start_ = rhs.basis_start_;
+
+  VecDuplicate(rhs.InitialVec, &InitialVec);
+  VecCopy(rhs.InitialVec, InitialVec);
+}
+
+/*******************************************************************************/
+// Assignment operator
+/*******************************************************************************/
+InitialState &InitialState::operator=(const InitialState &rhs)
+{
+  std::cout << "Assignment operator (diagonal op) has been called!" << std::endl;
+    
+  if(this != &rhs){
+    VecDestroy(&InitialVec);
+      
+    l_ = rhs.l_;
+    n_ = rhs.n_;
+    sector_ = rhs.sector_;
+    mpirank_ = rhs.mpirank_;
+    mpisize_ = rhs.mpisize_;
+    comm_ = rhs.comm_;
+    nlocal_ = rhs.nlocal_;
+    start_ = rhs.start_;
+    end_ = rhs.end_;
+    basis_size_ = rhs.basis_size_;
+    basis_start_ = rhs.basis_start_;
+
+    VecDuplicate(rhs.InitialVec, &InitialVec);
+    VecCopy(rhs.InitialVec, InitialVec);
+  }
+
+  return *this;
+}
+
+InitialState::~InitialState()
+{
+  VecDestroy(&InitialVec);
+}
+
+/*******************************************************************************/
+// Neel state
+/*******************************************************************************/
+void InitialState::neel_initial_state()
+{
+  State neel;
+  if(!sector_.neel(neel)){
+    std::cerr << "Not implemented!" << std::endl;
+    std::cerr << "Neel state has only been implemented for half-filled systems" << std::endl;
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+
+  set_elements_(std::vector<State>(1, neel), std::vector<PetscScalar>(1, 1.0));
+}
+
+/*******************************************************************************/
+// Every pattern is checked on every process, so that all of them abort
+/*******************************************************************************/
+void InitialState::product_initial_state(const std::vector<std::string> &patterns,
+                                         const std::vector<PetscScalar> &amplitudes,
+                                         bool verbose)
+{
+  std::vector<State> states(patterns.size());
+  for(std::size_t k = 0; k < patterns.size(); ++k){
+    if(!sector_.product_state(patterns[k], states[k])){
+      if(mpirank_ == 0) std::cerr << "Invalid initial pattern " << patterns[k] 
+        << " for this model and sector" << std::endl;
+      MPI_Abort(PETSC_COMM_WORLD, 1);
+    }
+  }
+
+  set_elements_(states, amplitudes);
+
+  if(verbose && mpirank_ == 0){
+    std::cout << "Initial state: ";
+    for(std::size_t k = 0; k < patterns.size(); ++k)
+      std::cout << (k ? " + " : "") << "(" << amplitudes[k] << ") |" << patterns[k] << ">";
+    std::cout << std::endl;
+  }
+}
+
+/*******************************************************************************/
+// The global index of every element follows from the ranking, and only the
+// process owning it sets the entry, so no process needs the whole basis and
+// the assembly moves no values
+/*******************************************************************************/
+void InitialState::set_elements_(const std::vector<State> &states,
+                                 const std::vector<PetscScalar> &amplitudes)
+{
+  Log::stage_push(Log::STAGE_INITIAL_STATE);
+  Log::event_begin(Log::EVENT_INITIAL_STATE);
+
+  PetscInt start, end;
+  VecGetOwnershipRange(InitialVec, &start, &end);
+
+  VecSet(InitialVec, 0.0);
+  for(std::size_t k = 0; k < states.size(); ++k){
+    LLInt index = sector_.rank(states[k]);
+    if(index >= start && index < end) VecSetValue(InitialVec, index, amplitudes[k], ADD_VALUES);
+  }
+
+  VecAssemblyBegin(InitialVec);
+  VecAssemblyEnd(InitialVec);
+  VecNormalize(InitialVec, NULL);
+
+  Log::event_end(Log::EVENT_INITIAL_STATE);
+  Log::stage_pop();
+}
+
+/*******************************************************************************/
+// Initial random state out of the computational basis
+/*******************************************************************************/
+void InitialState::random_initial_state(State *int_basis,
+                                        bool wtime,
+                                        bool verbose)
+{
+  Log::stage_push(Log::STAGE_INITIAL_STATE);
+  Log::event_begin(Log::EVENT_INITIAL_STATE);
+
+  LLInt pick_ind;
+  boost::random::mt19937 gen;
+
+  if(wtime) gen.seed(static_cast<LLInt>(std::time(0)));
+
+  if(mpirank_ == 0){
+    boost::random::uniform_int_distribution<LLInt> dist(0, basis_size_ - 1);
+    pick_ind = dist(gen);
+  }
+  MPI_Bcast(&pick_ind, 1, MPI_LONG_LONG_INT, 0, comm_);
+
+  // The element is printed and set by the process that owns it
+  if(pick_ind >= start_ && pick_ind < end_){
+    if(verbose){
+      State pick = int_basis[pick_ind - basis_start_];
+      std::cout << "Initial state randomly chosen: " << pick << std::endl;
+      std::cout << "With binary representation: " << std::endl;
+      std::cout << Utils::state_to_binary(pick, sector_.bits()) << std::endl;
+    }
+    VecSetValue(InitialVec, pick_ind, 1.0, INSERT_VALUES);
+  }
+
+  VecAssemblyBegin(InitialVec);
+  VecAssemblyEnd(InitialVec);
+
+  Log::event_end(Log::EVENT_INITIAL_STATE);
+  Log::stage_pop();
+}
+
+/*******************************************************************************/
+// Box-Muller amplitudes with E|c|^2 = 1. The squares are summed as integers,
+// with a resolution such that the sum of D of them stays below 2^56
+/*******************************************************************************/
+void InitialState::typical_initial_state(ULLInt seed,
+                                         bool verbose)
+{
+  Log::stage_push(Log::STAGE_INITIAL_STATE);
+  Log::event_begin(Log::EVENT_INITIAL_STATE);
+
+  const double pi = boost::math::constants::pi<double>();
+
+  int bits = 0;
+  while((1LL << bits) < basis_size_) ++bits;
+  double resolution = std::ldexp(1.0, 56 - bits);
+
+  PetscInt start, end;
+  PetscScalar *a;
+  VecGetOwnershipRange(InitialVec, &start, &end);
+  VecGetArray(InitialVec, &a);
+
+  ULLInt norm2 = 0;
+  for(PetscInt i = start; i < end; ++i){
+    PetscReal u0, u1;
+    Utils::random_pair(i, 0, seed, u0, u1);
+    PetscReal r = std::sqrt(-std::log(u0));
+    a[i - start] = r * std::cos(2.0 * pi * u1) + PETSC_i * r * std::sin(2.0 * pi * u1);
+    norm2 += static_cast<ULLInt> (r * r * resolution + 0.5);
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE, &norm2, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, comm_);
+  PetscReal norm = std::sqrt(norm2 / resolution);
+  for(PetscInt i = 0; i < end - start; ++i) a[i] /= norm;
+
+  VecRestoreArray(InitialVec, &a);
+
+  if(verbose && mpirank_ == 0)
+    std::cout << "Typical initial state with seed " << seed << std::endl;
+
+  Log::event_end(Log::EVENT_INITIAL_STATE);
+  Log::stage_pop();
+}
+
+/*******************************************************************************/
+// Scatters the vector such that local row i of the new layout holds the entry
+// of the global basis index ordering[i]
+/*******************************************************************************/
+void InitialState::reorder_rows(IS ordering)
+{
+  Log::stage_push(Log::STAGE_INITIAL_STATE);
+  Log::event_begin(Log::EVENT_INITIAL_STATE);
+
+  Vec reordered;
+  VecScatter scatter;
+
+  ISGetLocalSize(ordering, &nlocal_);
+  VecCreateMPI(comm_, nlocal_, basis_size_, &reordered);
+
+  VecScatterCreate(InitialVec, ordering, reordered, NULL, &scatter);
+  VecScatterBegin(scatter, InitialVec, reordered, INSERT_VALUES, SCATTER_FORWARD);
+  VecScatterEnd(scatter, InitialVec, reordered, INSERT_VALUES, SCATTER_FORWARD);
+  VecScatterDestroy(&scatter);
+
+  VecDestroy(&InitialVec);
+  InitialVec = reordered;
+  VecGetOwnershipRange(InitialVec, &start_, &end_);
+
+  Log::event_end(Log::EVENT_INITIAL_STATE);
+  Log::stage_pop();
+}
+
+/*******************************************************************************/
+// Lowest eigenpair of the given Hamiltonian, the eigenvector is normalised
+/*******************************************************************************/
+void InitialState::ground_state(const Mat &ham_mat, bool verbose)
+{
+  Log::stage_push(Log::STAGE_INITIAL_STATE);
+  Log::event_begin(Log::EVENT_INITIAL_STATE);
+
+  EPS eps;
+  EPSCreate(comm_, &eps);
+  EPSSetOperators(eps, ham_mat, NULL);
+  EPSSetProblemType(eps, EPS_HEP);
+  EPSSetType(eps, EPSKRYLOVSCHUR);
+  EPSSetWhichEigenpairs(eps, EPS_SMALLEST_REAL);
+  EPSSetDimensions(eps, 1, PETSC_DEFAULT, PETSC_DEFAULT);
+  EPSSetOptionsPrefix(eps, "gs_");
+  EPSSetFromOptions(eps);
+  EPSSolve(eps);
+
+  PetscInt nconv;
+  EPSGetConverged(eps, &nconv);
+  if(nconv < 1){
+    std::cerr << "Ground state solver did not converge, aborting" << std::endl;
+    std::cerr << "Change tolerance or maximum number of iterations (-gs_eps_*)" << std::endl;
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+
+  PetscScalar kr, ki;
+  EPSGetEigenpair(eps, 0, &kr, &ki, InitialVec, NULL);
+  EPSDestroy(&eps);
+
+  if(verbose && mpirank_ == 0)
+    std::cout << "Ground state energy: " << PetscRealPart(kr) << std::endl;
+
+  Log::event_end(Log::EVENT_INITIAL_STATE);
+  Log::stage_pop();
+}
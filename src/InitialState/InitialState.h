@@ -0,0 +1,119 @@
+/** @addtogroup Core
+ * @{
+ */
+/**
+ * \class InitialState.
+ * \ingroup Core
+ * \brief A class to construct initial states for time evolution.
+ *
+ * Supports a Neel state, product states and their superpositions, a random state, a typical
+ * state and the ground state of a Hamiltonian (quench). We note that a random state in this
+ * context refers to an initial state randomly picked out of the computational basis, while a
+ * typical state is a random superposition of all the basis elements.
+ */
+#ifndef __INITIAL_STATE_H
+#define __INITIAL_STATE_H
+
+#include <string>
+#include <vector>
+
+#include "../Environment/Environment.h"
+#include "../Utils/Utils.h"
+#include "../Basis/Basis.h"
+#include "../Log/Log.h"
+
+class InitialState
+{
+  public:
+    /** \brief Creates an instance of class InitialState.
+      * \param env An instance of the class Environment.
+      * \param basis An instance of class Basis.
+      *
+      * This is the only available constructor of this class.
+      */
+    InitialState(const Environment &env,
+                 const Basis &basis);
+    /** \brief Destructor.
+      * 
+      * Destroys the initial state vector automatically.
+      */ 
+    ~InitialState();
+    /// Copy constructor.
+    InitialState(const InitialState &rhs);
+    /// Overloading of the assignment operator.
+    InitialState &operator=(const InitialState &rhs);
+    Vec InitialVec; ///< Initial state represented as a vector in Hilbert space with same parallel layout.
+    /** \brief Method to compute the Neel state.
+      *
+      * Set by the process owning it, see product_initial_state().
+      */
+    void neel_initial_state();
+    /** \brief Method to compute a product state, or a superposition of product states.
+      * \param patterns Occupation of every site of every product state, see
+      *                 Sector::product_state().
+      * \param amplitudes Amplitude of every product state, the state is normalised afterwards.
+      * \param verbose If true, prints to stdout the superposition.
+      *
+      * The global index of every product state is computed with the ranking of the sector
+      * and the entry is set by the process owning it, so the basis is not needed. Should be
+      * called before reorder_rows().
+      */
+    void product_initial_state(const std::vector<std::string> &patterns,
+                               const std::vector<PetscScalar> &amplitudes,
+                               bool verbose = false);
+    /** \brief Method to compute a random initial state.
+      * \param int_basis The integer basis, a member of class Basis.
+      * \param wtime If true, random state changes with each execution based on current time.
+      * \param verbose If true, prints to stdout the random state chosen.
+      *
+      * RNG is Mersenne-Twister from Boost.
+      */     
+    void random_initial_state(State *int_basis,
+                              bool wtime = false,
+                              bool verbose = false);
+    /** \brief Method to compute a typical (Haar random) state, dense in the whole Hilbert space.
+      * \param seed Seed of the random amplitudes.
+      * \param verbose If true, prints to stdout the seed.
+      *
+      * The amplitudes are complex Gaussian numbers from a counter-based generator keyed on
+      * the global basis index, see Utils::random_pair(), so every process fills its own
+      * rows in parallel and the state is the same for any number of processes. The norm is
+      * summed in fixed point, which makes also the normalisation independent of the order
+      * of the reduction. Should be called before reorder_rows().
+      */
+    void typical_initial_state(ULLInt seed,
+                               bool verbose = false);
+    /** \brief Maps the initial state onto the layout of a reordered Hamiltonian matrix.
+      * \param ordering The permutation, member RowOrdering of class SparseOp.
+      *
+      * Should be called after the initial state has been computed in the basis order,
+      * see SparseOp::reorder_rows().
+      */
+    void reorder_rows(IS ordering);
+    /** \brief Ground state of a Hamiltonian, e.g. the pre-quench one.
+      * \param ham_mat The Hamiltonian matrix, in the layout of InitialVec (after reorder_rows()).
+      * \param verbose If true, prints to stdout the ground state energy.
+      *
+      * Computed with SLEPc's EPS (Krylov-Schur, i.e. thick restarted Lanczos for a Hermitian
+      * matrix), which can be tuned with the options prefix -gs_ (e.g. -gs_eps_tol).
+      */
+    void ground_state(const Mat &ham_mat,
+                      bool verbose = false);
+  private:
+    unsigned int l_; ///< Number of sites.  
+    unsigned int n_; ///< Subspace descriptor.
+    PetscMPIInt mpirank_; ///< Index of the local processor.
+    PetscMPIInt mpisize_; ///< Total number of processors.
+    MPI_Comm comm_; ///< Communicator of the group of the process.
+    LLInt basis_size_; ///< Dimension of the Hilbert space. 
+    PetscInt nlocal_; ///< Local amount of rows owned by processor (PETSc).
+    PetscInt start_; ///< Global index (PETSc).
+    PetscInt end_; ///< Global index (PETSc).
+    PetscInt basis_start_; ///< Global index of the first element of the int_basis given to it.
+    Sector sector_; ///< Encoding of the basis elements.
+    /// Sets the given elements with their amplitudes, normalised.
+    void set_elements_(const std::vector<State> &states,
+                       const std::vector<PetscScalar> &amplitudes);
+};
+#endif
+/** @}*/
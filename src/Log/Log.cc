@@ -0,0 +1,166 @@
+#include "Log.h"
+
+#include <fstream>
+
+namespace Log
+{
+  namespace
+  {
+    const char *stage_names[N_STAGES] = {"Basis", "Hamiltonian", "Initial state",
+      "Time evolution", "Spectral"};
+    const char *event_names[N_EVENTS] = {"BasisConstruct", "Distribution", "Preallocation",
+      "Exchange", "Insertion", "Assembly", "Reorder", "InitialState", "KrylovEvo",
+      "SpectralBounds", "KPMMoments", "PolfedSolve", "RayleighRitz",
+      "ResultsOutput"};
+    const char *counter_names[N_COUNTERS] = {"cont_size", "requests", "exchange_steps",
+      "bytes_exchanged", "binsearch_calls", "krylov_iterations",
+      "spectral_matvecs"};
+
+    PetscLogStage stages[N_STAGES];
+    PetscLogEvent events[N_EVENTS];
+    double event_start[N_EVENTS];
+    double event_time[N_EVENTS];
+    LLInt event_calls[N_EVENTS];
+    double event_memory[N_EVENTS];
+    PetscLogDouble event_peak_start[N_EVENTS];
+    LLInt counters[N_COUNTERS];
+  }
+
+  void register_phases()
+  {
+    PetscClassId classid;
+    PetscClassIdRegister("DSQMKryST", &classid);
+
+    // PETSc keeps the maximum resident memory seen by every usage query and by the
+    // destruction of its objects, from now on
+    PetscMemorySetGetMaximumUsage();
+
+    for(int i = 0; i < N_STAGES; ++i)
+      PetscLogStageRegister(stage_names[i], &stages[i]);
+
+    for(int i = 0; i < N_EVENTS; ++i){
+      PetscLogEventRegister(event_names[i], classid, &events[i]);
+      event_time[i] = 0.0;
+      event_calls[i] = 0;
+      event_memory[i] = 0.0;
+    }
+
+    for(int i = 0; i < N_COUNTERS; ++i) counters[i] = 0;
+  }
+
+  void stage_push(Stage stage)
+  {
+    PetscLogStagePush(stages[stage]);
+  }
+
+  void stage_pop()
+  {
+    PetscLogStagePop();
+  }
+
+  void sample_memory(Event event)
+  {
+    PetscLogDouble mem;
+    PetscMemoryGetCurrentUsage(&mem);
+    if(mem > event_memory[event]) event_memory[event] = mem;
+  }
+
+  void event_begin(Event event)
+  {
+    sample_memory(event);
+    PetscMemoryGetMaximumUsage(&event_peak_start[event]);
+    PetscLogEventBegin(events[event], 0, 0, 0, 0);
+    event_start[event] = MPI_Wtime();
+  }
+
+  void event_end(Event event)
+  {
+    event_time[event] += MPI_Wtime() - event_start[event];
+    event_calls[event]++;
+    PetscLogEventEnd(events[event], 0, 0, 0, 0);
+    sample_memory(event);
+
+    // A maximum raised since the beginning was reached within the event
+    PetscLogDouble peak;
+    PetscMemoryGetMaximumUsage(&peak);
+    if(peak > event_peak_start[event] && peak > event_memory[event]) event_memory[event] = peak;
+  }
+
+  void count(Counter counter, LLInt amount)
+  {
+    counters[counter] += amount;
+  }
+
+  LLInt counter_value(Counter counter)
+  {
+    return counters[counter];
+  }
+
+  double event_seconds(Event event)
+  {
+    return event_time[event];
+  }
+
+  /*******************************************************************************/
+  // Values of every process are gathered on the first one, which writes them as
+  // arrays indexed by rank
+  /*******************************************************************************/
+  void write_summary(const char *filename, const char *approach)
+  {
+    PetscMPIInt mpirank, mpisize;
+    MPI_Comm_rank(PETSC_COMM_WORLD, &mpirank);
+    MPI_Comm_size(PETSC_COMM_WORLD, &mpisize);
+
+    double *all_times = NULL;
+    double *all_memory = NULL;
+    LLInt *all_counters = NULL;
+    if(mpirank == 0){
+      all_times = new double[N_EVENTS * mpisize];
+      all_memory = new double[N_EVENTS * mpisize];
+      all_counters = new LLInt[N_COUNTERS * mpisize];
+    }
+
+    MPI_Gather(event_time, N_EVENTS, MPI_DOUBLE, all_times, N_EVENTS, MPI_DOUBLE, 0,
+      PETSC_COMM_WORLD);
+    MPI_Gather(event_memory, N_EVENTS, MPI_DOUBLE, all_memory, N_EVENTS, MPI_DOUBLE, 0,
+      PETSC_COMM_WORLD);
+    MPI_Gather(counters, N_COUNTERS, MPI_LONG_LONG, all_counters, N_COUNTERS, MPI_LONG_LONG,
+      0, PETSC_COMM_WORLD);
+
+    if(mpirank == 0){
+      std::ofstream out(filename);
+      out.precision(9);
+
+      out << "{" << std::endl;
+      out << "  \"approach\": \"" << approach << "\"," << std::endl;
+      out << "  \"ranks\": " << mpisize << "," << std::endl;
+
+      out << "  \"events\": {" << std::endl;
+      for(int i = 0; i < N_EVENTS; ++i){
+        out << "    \"" << event_names[i] << "\": {\"calls\": " << event_calls[i]
+          << ", \"time\": [";
+        for(PetscMPIInt p = 0; p < mpisize; ++p)
+          out << (p ? ", " : "") << all_times[p * N_EVENTS + i];
+        out << "], \"memory_mb\": [";
+        for(PetscMPIInt p = 0; p < mpisize; ++p)
+          out << (p ? ", " : "") << all_memory[p * N_EVENTS + i] / (1024.0 * 1024.0);
+        out << "]}" << (i + 1 < N_EVENTS ? "," : "") << std::endl;
+      }
+      out << "  }," << std::endl;
+
+      out << "  \"counters\": {" << std::endl;
+      for(int i = 0; i < N_COUNTERS; ++i){
+        out << "    \"" << counter_names[i] << "\": [";
+        for(PetscMPIInt p = 0; p < mpisize; ++p)
+          out << (p ? ", " : "") << all_counters[p * N_COUNTERS + i];
+        out << "]" << (i + 1 < N_COUNTERS ? "," : "") << std::endl;
+      }
+      out << "  }" << std::endl;
+      out << "}" << std::endl;
+    }
+
+    delete [] all_times;
+    delete [] all_memory;
+    delete [] all_counters;
+  }
+}
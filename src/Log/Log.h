@@ -0,0 +1,86 @@
+/** @addtogroup Core
+ * @{
+ */
+/**
+ * \namespace Log
+ * \ingroup Core
+ * \brief Phase-level profiling of the application.
+ *
+ * Every phase of the pipeline is registered as a PETSc log stage/event, so it shows up
+ * separately in -log_view. Additionally, the wall time and memory high-water mark of each
+ * event and a few counters are accumulated per process, and written as a JSON summary at the end of the execution
+ * if the runtime option -phase_summary <file> is given.
+ */
+#ifndef __LOG_H
+#define __LOG_H
+
+#include "../Environment/Environment.h"
+
+namespace Log
+{
+  /// Log stages, the main steps of the pipeline.
+  enum Stage { STAGE_BASIS, STAGE_HAMILTONIAN, STAGE_INITIAL_STATE, STAGE_TIME_EVO, STAGE_SPECTRAL,
+               N_STAGES };
+  /// Log events, the phases within each stage.
+  enum Event { EVENT_BASIS, EVENT_DISTRIBUTION, EVENT_PREALLOCATION, EVENT_EXCHANGE,
+               EVENT_INSERTION, EVENT_ASSEMBLY, EVENT_REORDER, EVENT_INITIAL_STATE,
+               EVENT_KRYLOV, EVENT_BOUNDS, EVENT_MOMENTS, EVENT_POLFED, EVENT_RITZ, EVENT_OUTPUT,
+               N_EVENTS };
+  /// Per process counters.
+  enum Counter { COUNTER_CONT, COUNTER_REQUESTS, COUNTER_EXCHANGE_STEPS, COUNTER_BYTES,
+                 COUNTER_BINSEARCH, COUNTER_KRYLOV_ITS, COUNTER_MATVECS, N_COUNTERS };
+  /** \brief Registers the stages and events with PETSc's logging.
+    *
+    * Called by the constructor of class Environment, after PETSc has been initialised.
+    */
+  void register_phases();
+  /** \brief Pushes a log stage.
+    * \param stage The stage.
+    */
+  void stage_push(Stage stage);
+  /// Pops the current log stage.
+  void stage_pop();
+  /** \brief Samples the memory usage within an event.
+    * \param event The event, which must be running.
+    *
+    * Called right after the large allocations of an event, which may be released before
+    * it ends.
+    */
+  void sample_memory(Event event);
+  /** \brief Starts timing an event, and samples the memory usage.
+    * \param event The event.
+    */
+  void event_begin(Event event);
+  /** \brief Stops timing an event, and samples the memory usage.
+    * \param event The event.
+    *
+    * The high-water mark of each event is the largest resident memory reported by
+    * PetscMemoryGetCurrentUsage() at its boundaries and by sample_memory(), or the
+    * maximum of PetscMemoryGetMaximumUsage() if it was raised during the event.
+    */
+  void event_end(Event event);
+  /** \brief Accumulates a counter of the local process.
+    * \param counter The counter.
+    * \param amount Value to add.
+    */
+  void count(Counter counter,
+             LLInt amount);
+  /** \brief Current value of a counter of the local process.
+    * \param counter The counter.
+    * \return The accumulated value.
+    */
+  LLInt counter_value(Counter counter);
+  /** \brief Wall time accumulated by an event on the local process.
+    * \param event The event.
+    * \return Seconds spent in the event so far.
+    */
+  double event_seconds(Event event);
+  /** \brief Writes the per process timings, memory and counters, collective.
+    * \param filename Output file, written by the first process.
+    * \param approach Name of the approach.
+    */
+  void write_summary(const char *filename,
+                     const char *approach);
+}
+#endif
+/** @}*/
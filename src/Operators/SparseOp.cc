@@ -0,0 +1,861 @@
+#include "SparseOp.h"
+
+#include <algorithm>
+
+namespace
+{
+  // Entries of a row are sorted by column only, values are complex
+  bool column_less(const std::pair<PetscInt, PetscScalar> &a, 
+                   const std::pair<PetscInt, PetscScalar> &b)
+  {
+    return a.first < b.first;
+  }
+}
+
+/*******************************************************************************/
+// Single custom constructor for this class.
+// Creates the Hamiltonian matrix depending on the basis chosen.
+/*******************************************************************************/
+SparseOp::SparseOp(const Environment &env, const Basis &basis) : sector_(basis.sector)
+{
+  l_ = env.l;
+  n_ = env.n;
+  mpirank_ = env.mpirank;
+  mpisize_ = env.mpisize;
+  comm_ = env.comm;
+  node_rank_ = env.node_rank;
+  node_size_ = env.node_size;
+  nlocal_ = basis.nlocal;
+  start_ = basis.start;
+  end_ = basis.end;
+  basis_size_ = basis.basis_size;
+  basis_local_ = basis.basis_local;
+  basis_start_ = basis.basis_start;
+  assembly_buffer_mb_ = env.assembly_buffer_mb;
+  lookup_policy_ = env.lookup_policy;
+  MPI_Comm_dup(env.node_comm, &node_comm_);
+
+  MatCreate(comm_, &HamMat);
+  MatSetSizes(HamMat, nlocal_, nlocal_, basis_size_, basis_size_);
+  MatSetType(HamMat, MATMPIAIJ);
+
+  RowOrdering = NULL;
+  d_i_ = d_j_ = o_i_ = o_j_ = NULL;
+  d_a_ = o_a_ = NULL;
+
+  t_ = beta_ = 0.0;
+  InteractionDiag = OnSiteDiag = diag_work_ = NULL;
+}
+
+/*******************************************************************************/
+// Copy constructor
+/*******************************************************************************/
+SparseOp::SparseOp(const SparseOp &rhs) : sector_(rhs.sector_)
+{
+  std::cout << "Copy constructor (ham matrix) has been called!" << std::endl;
+
+  l_ = rhs.l_;
+  n_ = rhs.n_;
+  mpirank_ = rhs.mpirank_;
+  mpisize_ = rhs.mpisize_;
+  comm_ = rhs.comm_;
+  node_rank_ = rhs.node_rank_;
+  node_size_ = rhs.node_size_;
+  nlocal_ = rhs.nlocal_;
+  start_ = rhs.start_;
+  end_ = rhs.end_;
+  basis_size_ = rhs.basis_size_;
+  basis_local_ = rhs.basis_local_;
+  basis_start_ = rhs.basis_start_;
+  assembly_buffer_mb_ = rhs.assembly_buffer_mb_;
+  lookup_policy_ = rhs.lookup_policy_;
+  
+  MPI_Comm_dup(rhs.node_comm_, &node_comm_);
+  MatDuplicate(rhs.HamMat, MAT_COPY_VALUES, &HamMat);
+  d_i_ = d_j_ = o_i_ = o_j_ = NULL;
+  d_a_ = o_a_ = NULL;
+  RowOrdering = NULL;
+  if(rhs.RowOrdering) ISDuplicate(rhs.RowOrdering, &RowOrdering);
+  t_ = rhs.t_;
+  beta_ = rhs.beta_;
+  hop_stash_ = rhs.hop_stash_;
+  InteractionDiag = OnSiteDiag = diag_work_ = NULL;
+  if(rhs.InteractionDiag){
+    VecDuplicate(rhs.InteractionDiag, &InteractionDiag);
+    VecCopy(rhs.InteractionDiag, InteractionDiag);
+    VecDuplicate(rhs.OnSiteDiag, &OnSiteDiag);
+    VecCopy(rhs.OnSiteDiag, OnSiteDiag);
+    VecDuplicate(rhs.diag_work_, &diag_work_);
+  }
+}
+
+/*******************************************************************************/
+// Assignment operator
+/*******************************************************************************/
+SparseOp &SparseOp::operator=(const SparseOp &rhs)
+{
+  std::cout << "Assignment operator (ham matrix) has been called!" << std::endl;
+    
+  if(this != &rhs){
+    MatDestroy(&HamMat);
+    destroy_csr_();
+    ISDestroy(&RowOrdering);
+    destroy_parts_();
+    MPI_Comm_free(&node_comm_);    
+
+    l_ = rhs.l_;
+    n_ = rhs.n_;
+    mpirank_ = rhs.mpirank_;
+    mpisize_ = rhs.mpisize_;
+    comm_ = rhs.comm_;
+    node_rank_ = rhs.node_rank_;
+    node_size_ = rhs.node_size_;
+    nlocal_ = rhs.nlocal_;
+    start_ = rhs.start_;
+    end_ = rhs.end_;
+    basis_size_ = rhs.basis_size_;
+    basis_local_ = rhs.basis_local_;
+    basis_start_ = rhs.basis_start_;
+    assembly_buffer_mb_ = rhs.assembly_buffer_mb_;
+    lookup_policy_ = rhs.lookup_policy_;
+    sector_ = rhs.sector_;
+  
+    MPI_Comm_dup(rhs.node_comm_, &node_comm_);
+    MatDuplicate(rhs.HamMat, MAT_COPY_VALUES, &HamMat);
+    RowOrdering = NULL;
+    if(rhs.RowOrdering) ISDuplicate(rhs.RowOrdering, &RowOrdering);
+    t_ = rhs.t_;
+    beta_ = rhs.beta_;
+    hop_stash_ = rhs.hop_stash_;
+    InteractionDiag = OnSiteDiag = diag_work_ = NULL;
+    if(rhs.InteractionDiag){
+      VecDuplicate(rhs.InteractionDiag, &InteractionDiag);
+      VecCopy(rhs.InteractionDiag, InteractionDiag);
+      VecDuplicate(rhs.OnSiteDiag, &OnSiteDiag);
+      VecCopy(rhs.OnSiteDiag, OnSiteDiag);
+      VecDuplicate(rhs.diag_work_, &diag_work_);
+    }
+  }
+
+  return *this;
+}
+
+SparseOp::~SparseOp()
+{
+  MatDestroy(&HamMat);
+  destroy_csr_();
+  ISDestroy(&RowOrdering);
+  destroy_parts_();
+  MPI_Comm_free(&node_comm_);
+}
+
+/*******************************************************************************/
+// Collects the nonlocal start index (global indices) of every processor, to be used
+// during the construction of the matrix
+/*******************************************************************************/
+void SparseOp::gather_nonlocal_values_(LLInt *start_inds)
+{
+  MPI_Allgather(&start_, 1, MPI_LONG_LONG, start_inds, 1, MPI_LONG_LONG, 
+    comm_);
+}
+
+/*******************************************************************************/
+// Determines the sparsity pattern to allocate memory only for the non-zero 
+// entries of the matrix
+/*******************************************************************************/
+void SparseOp::determine_allocation_details_(State *int_basis, 
+                                             std::vector<LLInt> &cont, 
+                                             std::vector<LLInt> &st, 
+                                             PetscInt *diag, 
+                                             PetscInt *off,
+                                             PetscInt *staging)
+{
+  Log::event_begin(Log::EVENT_PREALLOCATION);
+
+  for(PetscInt i = 0; i < nlocal_; ++i) diag[i] = 1;
+
+  // Elements not held locally, their global indices are resolved after the loop
+  std::vector<State> missing;
+  missing.reserve(st.capacity());
+
+  // Position in the staging buffer. Rows are visited in order and every hop takes one
+  // entry, non-local targets are stored as -(position in missing + 1) until resolved
+  LLInt pos = 0;
+
+  std::vector<State> targets(sector_.max_hops());
+  std::vector<double> factors(sector_.max_hops());
+
+  for(PetscInt state = start_; state < end_; ++state){
+
+    State bs = int_basis[state - basis_start_];
+
+    // Loop over all the hops of the element, see Sector::hops()
+    unsigned int n_hops = sector_.hops(bs, &targets[0], &factors[0]);
+    for(unsigned int k = 0; k < n_hops; ++k){
+      const State &new_state = targets[k];
+      // Look for a match among the elements held locally
+      LLInt match_ind = Utils::binsearch(int_basis, basis_local_, new_state); 
+      if(match_ind == -1){
+        missing.push_back(new_state);
+        st.push_back(state);
+        if(staging) staging[pos++] = -static_cast<LLInt>(missing.size());
+        continue;
+      }
+      match_ind += basis_start_;
+
+      if(staging) staging[pos++] = match_ind;
+      if(match_ind < end_ && match_ind >= start_) diag[state - start_]++;
+      else off[state - start_]++; 
+    }
+  }
+
+  Log::event_end(Log::EVENT_PREALLOCATION);
+  Log::event_begin(Log::EVENT_EXCHANGE);
+
+  // Only the sorted, unique set of missing states is resolved
+  std::vector<State> requests;
+  Utils::build_request_table(missing, requests, cont);
+  Log::sample_memory(Log::EVENT_EXCHANGE);
+  std::vector<State>().swap(missing);
+  Log::count(Log::COUNTER_CONT, cont.size());
+  Log::count(Log::COUNTER_REQUESTS, requests.size());
+
+  // Every process takes part in the exchange, also without requests. Nothing is
+  // missing from the shared window
+  std::vector<LLInt> indices(requests.size(), -1);
+  if(lookup_policy_ == Environment::LOOKUP_NODE) resolve_by_node_(int_basis, requests, indices);
+  if(lookup_policy_ == Environment::LOOKUP_RING) resolve_by_ring_(int_basis, requests, indices);
+  if(lookup_policy_ == Environment::LOOKUP_RANK) resolve_by_ranking_(requests, indices);
+
+  Utils::expand_request_table(cont, indices);
+
+  // Now cont contains the missing indices
+  for(ULLInt in = 0; in < cont.size(); ++in){
+    if(cont[in] < 0){
+      std::cerr << "Error in the lookup of the basis elements within the Ham mat construction"
+        << std::endl;
+      MPI_Abort(PETSC_COMM_WORLD, 1);
+    }
+    LLInt st_c = st[in];
+    if(cont[in] < end_ && cont[in] >= start_) diag[st_c - start_]++;
+    else off[st_c - start_]++;
+  }
+  
+  // Replace the placeholders of the staging buffer with the resolved indices
+  if(staging){
+    for(LLInt k = 0; k < pos; ++k)
+      if(staging[k] < 0) staging[k] = cont[-staging[k] - 1];
+  }
+
+  Log::event_end(Log::EVENT_EXCHANGE);
+}
+
+/*******************************************************************************/
+// Node policy: the requests are sent to rank 0 of the node, which holds the
+// full basis and returns their global indices
+/*******************************************************************************/
+void SparseOp::resolve_by_node_(State *int_basis, 
+                                const std::vector<State> &requests, 
+                                std::vector<LLInt> &indices)
+{
+  LLInt *recv_sizes = NULL;
+  if(node_rank_ == 0) recv_sizes = new LLInt[node_size_ - 1];
+  // Communication to rank 0 of every node to find size of buffers
+  if(node_rank_){
+    LLInt requests_size = requests.size();
+    MPI_Send(&requests_size, 1, MPI_LONG_LONG, 0, node_rank_, node_comm_);
+  }
+  else{
+    for(PetscMPIInt i = 1; i < node_size_; ++i)
+      MPI_Recv(&recv_sizes[i - 1], 1, MPI_LONG_LONG, i, MPI_ANY_TAG, node_comm_, 
+       MPI_STATUS_IGNORE);
+  }
+
+  // Communication to rank 0 of each node to find missing indices, every element
+  // travels as STATE_WORDS integers. Processes without requests still take part,
+  // with empty messages (&v[0] is undefined for an empty vector)
+  if(node_rank_){
+    State *send = requests.empty() ? NULL : const_cast<State*>(&requests[0]);
+    LLInt *recv = indices.empty() ? NULL : &indices[0];
+    MPI_Send(send, requests.size() * STATE_WORDS, MPI_LONG_LONG, 0, node_rank_, node_comm_);
+    MPI_Recv(recv, indices.size(), MPI_LONG_LONG, 0, 0, node_comm_, MPI_STATUS_IGNORE);
+
+    Log::count(Log::COUNTER_EXCHANGE_STEPS, 1);
+    Log::count(Log::COUNTER_BYTES, requests.size() * (sizeof(State) + sizeof(LLInt))
+      + 2 * sizeof(LLInt));
+  }
+  else{
+    std::vector<State> buffer;
+    std::vector<LLInt> found;
+    for(PetscMPIInt i = 1; i < node_size_; ++i){
+      MPI_Status stat;
+      LLInt rsize = recv_sizes[i - 1];
+      buffer.resize(rsize);
+      found.resize(rsize);
+      State *recv = buffer.empty() ? NULL : &buffer[0];
+      LLInt *send = found.empty() ? NULL : &found[0];
+      MPI_Recv(recv, rsize * STATE_WORDS, MPI_LONG_LONG, i, i, node_comm_, &stat);
+    
+      Utils::sorted_search(int_basis, basis_size_, recv, rsize, send);
+      Log::sample_memory(Log::EVENT_EXCHANGE);
+      Log::count(Log::COUNTER_BINSEARCH, rsize);
+      Log::count(Log::COUNTER_EXCHANGE_STEPS, 1);
+      Log::count(Log::COUNTER_BYTES, rsize * (sizeof(State) + sizeof(LLInt)) 
+        + 2 * sizeof(LLInt));
+
+      MPI_Send(send, rsize, MPI_LONG_LONG, stat.MPI_SOURCE, 0, node_comm_);
+    }
+  }
+
+  delete [] recv_sizes;
+}
+
+/*******************************************************************************/
+// Ring policy: the basis is passed around all processes, each one of them
+// resolving the requests that fall in the section it receives
+/*******************************************************************************/
+void SparseOp::resolve_by_ring_(State *int_basis, 
+                                const std::vector<State> &requests, 
+                                std::vector<LLInt> &indices)
+{
+  // Collective communication of global indices
+  LLInt *start_inds = new LLInt[mpisize_];
+
+  gather_nonlocal_values_(start_inds);
+
+  // The largest section of the distribution is used as the size of the basis_help buffer.
+  // With the equal distribution this is the section of proc 0, but not for a non-zero 
+  // balanced distribution
+  LLInt basis_help_size;
+  LLInt nlocal_ll = nlocal_;
+  MPI_Allreduce(&nlocal_ll, &basis_help_size, 1, MPI_LONG_LONG, MPI_MAX, comm_);
+
+  // Create basis_help buffers and initialize them to the empty element
+  State *basis_help = new State[basis_help_size];
+  for(LLInt i = 0; i < basis_help_size; ++i) basis_help[i] = State();
+
+  // At the beginning basis_help is just int_basis, with the remaining values set to empty
+  // It's important that the array remains sorted for the lookup
+  for(LLInt i = 0; i < nlocal_; ++i)
+    basis_help[i + (basis_help_size - nlocal_)] = int_basis[i];
+  Log::sample_memory(Log::EVENT_EXCHANGE);
+
+  // Main communication procedure. A ring exchange of the int_basis using basis_help memory
+  // buffer, after a ring exchange occurs each processor looks for the missing indices of
+  // the Hamiltonian and stores their global indices. Both the requests and basis_help
+  // are sorted, so the lookup is a merge-join. Every element travels as STATE_WORDS
+  // integers
+  PetscMPIInt next = (mpirank_ + 1) % mpisize_;
+  PetscMPIInt prec = (mpirank_ + mpisize_ - 1) % mpisize_;
+
+  LLInt requests_size = requests.size();
+
+  for(PetscMPIInt exc = 0; exc < mpisize_ - 1; ++exc){
+ 
+    MPI_Sendrecv_replace(&basis_help[0], basis_help_size * STATE_WORDS, MPI_LONG_LONG, next, 0,
+      prec, 0, comm_, MPI_STATUS_IGNORE);
+
+    PetscMPIInt source = Utils::mod((prec - exc), mpisize_);
+    LLInt source_end = (source + 1 < mpisize_) ? start_inds[source + 1] : basis_size_;
+    LLInt padding = basis_help_size - (source_end - start_inds[source]);
+
+    LLInt j = padding;
+    for(LLInt i = 0; i < requests_size && j < basis_help_size; ++i){
+      if(indices[i] >= 0) continue;
+
+      while(j < basis_help_size && basis_help[j] < requests[i]) ++j;
+
+      if(j < basis_help_size && basis_help[j] == requests[i])
+        indices[i] = j - padding + start_inds[source];
+    }
+  }
+  
+  Log::count(Log::COUNTER_EXCHANGE_STEPS, mpisize_ - 1);
+  Log::count(Log::COUNTER_BYTES, 2 * (mpisize_ - 1) * basis_help_size * sizeof(State));
+
+  delete [] basis_help;
+  delete [] start_inds;
+}
+
+/*******************************************************************************/
+// Ranking policy: the global index is computed from the element itself, so
+// there's no communication at all
+/*******************************************************************************/
+void SparseOp::resolve_by_ranking_(const std::vector<State> &requests, 
+                                   std::vector<LLInt> &indices)
+{
+  for(ULLInt i = 0; i < requests.size(); ++i)
+    indices[i] = sector_.rank(requests[i]);
+}
+
+/*******************************************************************************/
+// Computes the Hamiltonian matrix given by means of the integer basis
+/*******************************************************************************/
+void SparseOp::construct_AA_hamiltonian(State *int_basis, 
+                                        double V, 
+                                        double t, 
+                                        double h,
+                                        double beta)
+{
+  Log::stage_push(Log::STAGE_HAMILTONIAN);
+
+  // Parts of a previous construction are stale
+  destroy_parts_();
+  t_ = t;
+  beta_ = beta;
+
+  // Preallocation. For this we need a hint on how many non-zero entries the matrix will
+  // have in the diagonal submatrix and the offdiagonal submatrices for each process
+
+  // Allocating memory only for the non-zero entries of the matrix
+  PetscInt *d_nnz, *o_nnz;
+  PetscCalloc1(nlocal_, &d_nnz);
+  PetscCalloc1(nlocal_, &o_nnz);
+
+  std::vector<LLInt> cont;
+  std::vector<LLInt> st;
+  st.reserve(basis_size_ / l_);
+ 
+  // Column indices resolved during preallocation are staged in CSR form, so the values
+  // can be inserted without repeating the lookups. The number of entries of each row is
+  // known in advance, the buffer is skipped if it exceeds the memory budget. The
+  // decision is kept apart from the pointer, which is NULL for an empty buffer
+  PetscInt *row_ptr, *staging = NULL;
+  PetscMalloc1(nlocal_ + 1, &row_ptr);
+  row_ptr[0] = 0;
+  for(PetscInt i = 0; i < nlocal_; ++i)
+    row_ptr[i + 1] = row_ptr[i] + sector_.row_nnz(int_basis[i + start_ - basis_start_]) - 1;
+  PetscInt n_terms = row_ptr[nlocal_];
+
+  double staging_mb = n_terms * sizeof(PetscInt) / (1024.0 * 1024.0);
+  bool use_staging = (assembly_buffer_mb_ < 0 || staging_mb <= assembly_buffer_mb_);
+  if(use_staging) PetscMalloc1(n_terms, &staging);
+  else PetscFree(row_ptr);
+ 
+  determine_allocation_details_(int_basis, cont, st, d_nnz, o_nnz, staging);
+  Log::count(Log::COUNTER_BINSEARCH, n_terms);
+
+  if(use_staging){
+    create_csr_matrix_(int_basis, row_ptr, staging, d_nnz, o_nnz, V, t, h, beta);
+
+    PetscFree(d_nnz);
+    PetscFree(o_nnz);
+    PetscFree(row_ptr);
+    PetscFree(staging);
+
+    MatSetOption(HamMat, MAT_SYMMETRIC, PETSC_TRUE);
+
+    Log::stage_pop();
+    return;
+  }
+
+  // Preallocation step
+  MatMPIAIJSetPreallocation(HamMat, 0, d_nnz, 0, o_nnz);
+
+  PetscFree(d_nnz);
+  PetscFree(o_nnz);
+
+  Log::event_begin(Log::EVENT_INSERTION);
+  Log::count(Log::COUNTER_BINSEARCH, n_terms);
+
+  // Hamiltonian matrix construction
+  PetscScalar ti = t;
+  PetscScalar Vi = V;
+  const double pi = boost::math::constants::pi<double>();
+
+  std::vector<PetscScalar> osc_term(l_);
+  for(unsigned int site = 0; site < l_; ++site)
+    osc_term[site] = h * cos(2 * pi * beta * site);
+
+  std::vector<State> targets(sector_.max_hops());
+  std::vector<double> factors(sector_.max_hops());
+
+  // Position in cont of the next missing element
+  ULLInt missing = 0;
+
+  // Grab 1 of the states, insert its diagonal entry and loop over its hops
+  for(PetscInt state = start_; state < end_; ++state){
+  
+    State bs = int_basis[state - basis_start_];
+
+    PetscScalar diag_term = Vi * static_cast<double> (sector_.interaction(bs));
+    for(unsigned int site = 0; site < l_; ++site)
+      diag_term += osc_term[site] * static_cast<double> (sector_.occupation(bs, site));
+    MatSetValues(HamMat, 1, &state, 1, &state, &diag_term, ADD_VALUES);
+
+    unsigned int n_hops = sector_.hops(bs, &targets[0], &factors[0]);
+    for(unsigned int k = 0; k < n_hops; ++k){
+      const State &new_state = targets[k];
+      PetscScalar hop_term = ti * factors[k];
+
+      // Loop over all states and look for a match, cont holds the missing ones in the
+      // same order
+      LLInt match_ind = Utils::binsearch(int_basis, basis_local_, new_state); 
+      if(match_ind == -1) match_ind = cont[missing++];
+      else match_ind += basis_start_;
+
+      MatSetValues(HamMat, 1, &match_ind, 1, &state, &hop_term, ADD_VALUES);
+    }
+  }
+
+  Log::event_end(Log::EVENT_INSERTION);
+  Log::event_begin(Log::EVENT_ASSEMBLY);
+
+  // The stash of the off-process values is released by the end of the assembly
+  MatAssemblyBegin(HamMat, MAT_FINAL_ASSEMBLY);
+  Log::sample_memory(Log::EVENT_ASSEMBLY);
+  MatAssemblyEnd(HamMat, MAT_FINAL_ASSEMBLY);
+
+  Log::event_end(Log::EVENT_ASSEMBLY);
+
+  MatSetOption(HamMat, MAT_SYMMETRIC, PETSC_TRUE);
+
+  Log::stage_pop();
+}
+
+/*******************************************************************************/
+// Second pass of the construction when the column indices are staged. The local
+// diagonal and off-diagonal blocks are written directly in PETSc's internal CSR
+// format, row by row with sorted columns, so the matrix is created without
+// going through MatSetValues and the assembly stash. By symmetry of the matrix
+// the row of a state holds the hopping terms towards its own targets
+/*******************************************************************************/
+void SparseOp::create_csr_matrix_(State *int_basis, 
+                                       PetscInt *row_ptr, 
+                                       PetscInt *staging, 
+                                       PetscInt *diag, 
+                                       PetscInt *off, 
+                                       double V, 
+                                       double t, 
+                                       double h, 
+                                       double beta)
+{
+  Log::event_begin(Log::EVENT_INSERTION);
+
+  const double pi = boost::math::constants::pi<double>();
+  PetscScalar ti = t;
+
+  std::vector<PetscScalar> osc_term(l_);
+  for(unsigned int site = 0; site < l_; ++site)
+    osc_term[site] = h * cos(2 * pi * beta * site);
+
+  // Upper bounds, repeated targets of a row are merged into a single entry
+  PetscInt d_total = 0, o_total = 0;
+  for(PetscInt i = 0; i < nlocal_; ++i){
+    d_total += diag[i];
+    o_total += off[i];
+  }
+
+  destroy_csr_();
+  PetscMalloc1(nlocal_ + 1, &d_i_);
+  PetscMalloc1(d_total, &d_j_);
+  PetscMalloc1(d_total, &d_a_);
+  PetscMalloc1(nlocal_ + 1, &o_i_);
+  PetscMalloc1(o_total, &o_j_);
+  PetscMalloc1(o_total, &o_a_);
+
+  d_i_[0] = 0;
+  o_i_[0] = 0;
+  PetscInt dk = 0, ok = 0;
+  std::vector<std::pair<PetscInt, PetscScalar> > cols(sector_.max_hops() + 1);
+  std::vector<State> targets(sector_.max_hops());
+  std::vector<double> factors(sector_.max_hops());
+
+  for(PetscInt state = start_; state < end_; ++state){
+    
+    PetscInt i = state - start_;
+    State bits = int_basis[state - basis_start_];
+
+    // The hops are visited in the order they were staged, pairing every column with its value
+    PetscScalar diag_term = V * static_cast<double> (sector_.interaction(bits));
+    for(unsigned int site = 0; site < l_; ++site)
+      diag_term += osc_term[site] * static_cast<double> (sector_.occupation(bits, site));
+
+    PetscInt ncols = sector_.hops(bits, &targets[0], &factors[0]);
+    for(PetscInt c = 0; c < ncols; ++c)
+      cols[c] = std::make_pair(staging[row_ptr[i] + c], ti * factors[c]);
+    cols[ncols] = std::make_pair(state, diag_term);
+    std::sort(cols.begin(), cols.begin() + ncols + 1, column_less);
+
+    for(PetscInt c = 0; c <= ncols; ++c){
+      PetscInt col = cols[c].first;
+      PetscScalar value = cols[c].second;
+      bool local = (col >= start_ && col < end_);
+
+      if(c > 0 && col == cols[c - 1].first){
+        if(local) d_a_[dk - 1] += value;
+        else o_a_[ok - 1] += value;
+      }
+      else if(local){
+        d_j_[dk] = col - start_;
+        d_a_[dk++] = value;
+      }
+      else{
+        o_j_[ok] = col;
+        o_a_[ok++] = value;
+      }
+    }
+
+    d_i_[i + 1] = dk;
+    o_i_[i + 1] = ok;
+  }
+
+  Log::event_end(Log::EVENT_INSERTION);
+  Log::event_begin(Log::EVENT_ASSEMBLY);
+
+  MatDestroy(&HamMat);
+  MatCreateMPIAIJWithSplitArrays(comm_, nlocal_, nlocal_, basis_size_, basis_size_, 
+    d_i_, d_j_, d_a_, o_i_, o_j_, o_a_, &HamMat);
+
+  Log::event_end(Log::EVENT_ASSEMBLY);
+}
+
+/*******************************************************************************/
+// The CSR arrays are used by HamMat without a copy, so they can only be freed 
+// after the matrix has been destroyed
+/*******************************************************************************/
+void SparseOp::destroy_csr_()
+{
+  PetscFree(d_i_);
+  PetscFree(d_j_);
+  PetscFree(d_a_);
+  PetscFree(o_i_);
+  PetscFree(o_j_);
+  PetscFree(o_a_);
+}
+
+/*******************************************************************************/
+// Ghost columns of the off-diagonal block are sorted, so the owner of each one
+// only has to be looked up when the previous owner range is exceeded
+/*******************************************************************************/
+void SparseOp::communication_statistics_(const char *label)
+{
+  Mat Ad, Ao;
+  const PetscInt *colmap;
+  const PetscInt *ranges;
+  PetscInt rows, ghosts;
+
+  MatMPIAIJGetSeqAIJ(HamMat, &Ad, &Ao, &colmap);
+  MatGetSize(Ao, &rows, &ghosts);
+  MatGetOwnershipRanges(HamMat, &ranges);
+
+  LLInt neighbours = 0;
+  PetscMPIInt owner = -1;
+  for(PetscInt i = 0; i < ghosts; ++i){
+    if(owner == -1 || colmap[i] >= ranges[owner + 1]){
+      owner = std::upper_bound(ranges, ranges + mpisize_ + 1, colmap[i]) - ranges - 1;
+      neighbours++;
+    }
+  }
+
+  LLInt local[2] = {neighbours, ghosts};
+  LLInt max[2], sum[2];
+  MPI_Reduce(local, max, 2, MPI_LONG_LONG, MPI_MAX, 0, comm_);
+  MPI_Reduce(local, sum, 2, MPI_LONG_LONG, MPI_SUM, 0, comm_);
+
+  if(mpirank_ == 0){
+    std::cout << "Communication pattern (" << label << " ordering)" << std::endl;
+    std::cout << "Neighbour processes max/avg: " << max[0] << "/" 
+      << static_cast<double>(sum[0]) / mpisize_ << std::endl;
+    std::cout << "Ghost vector entries max/avg: " << max[1] << "/" 
+      << static_cast<double>(sum[1]) / mpisize_ << std::endl;
+  }
+}
+
+/*******************************************************************************/
+// Partitioner-driven reordering. Each row is assigned to a process by the
+// partitioner, rows are then renumbered contiguously per process keeping their
+// relative order, and the matrix is redistributed with the new numbering
+/*******************************************************************************/
+void SparseOp::reorder_rows()
+{
+  if(RowOrdering){
+    std::cerr << "Rows of the Hamiltonian matrix have already been reordered" << std::endl;
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+  if(!hop_stash_.empty()){
+    std::cerr << "Rows of the Hamiltonian matrix cannot be reordered without hopping" << std::endl;
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+
+  Log::stage_push(Log::STAGE_HAMILTONIAN);
+
+  communication_statistics_("lexicographic");
+
+  Log::event_begin(Log::EVENT_REORDER);
+
+  MatPartitioning part;
+  IS part_is, num_is;
+  PetscInt *counts = new PetscInt[mpisize_];
+
+  MatPartitioningCreate(comm_, &part);
+  MatPartitioningSetAdjacency(part, HamMat);
+  MatPartitioningSetFromOptions(part);
+  MatPartitioningApply(part, &part_is);
+  MatPartitioningDestroy(&part);
+
+  ISPartitioningToNumbering(part_is, &num_is);
+  ISPartitioningCount(part_is, mpisize_, counts);
+  ISInvertPermutation(num_is, counts[mpirank_], &RowOrdering);
+  ISSort(RowOrdering);
+
+  Mat reordered;
+  MatGetSubMatrix(HamMat, RowOrdering, RowOrdering, MAT_INITIAL_MATRIX, &reordered);
+  MatDestroy(&HamMat);
+  destroy_csr_();
+  HamMat = reordered;
+  MatSetOption(HamMat, MAT_SYMMETRIC, PETSC_TRUE);
+
+  // The parts follow the same ordering
+  if(InteractionDiag){
+    reorder_vec_(InteractionDiag);
+    reorder_vec_(OnSiteDiag);
+    VecDestroy(&diag_work_);
+    VecDuplicate(InteractionDiag, &diag_work_);
+  }
+
+  nlocal_ = counts[mpirank_];
+  MatGetOwnershipRange(HamMat, &start_, &end_);
+
+  Log::event_end(Log::EVENT_REORDER);
+
+  communication_statistics_("reordered");
+
+  ISDestroy(&part_is);
+  ISDestroy(&num_is);
+  delete [] counts;
+
+  Log::stage_pop();
+}
+
+/*******************************************************************************/
+// The diagonal parts are computed from the basis, as in the construction
+/*******************************************************************************/
+void SparseOp::construct_diagonals(State *int_basis)
+{
+  if(RowOrdering){
+    std::cerr << "The Hamiltonian has to be split before reordering its rows" << std::endl;
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+
+  Log::stage_push(Log::STAGE_HAMILTONIAN);
+
+  VecDestroy(&InteractionDiag);
+  VecDestroy(&OnSiteDiag);
+  VecDestroy(&diag_work_);
+  MatCreateVecs(HamMat, &InteractionDiag, &OnSiteDiag);
+  VecDuplicate(InteractionDiag, &diag_work_);
+
+  const double pi = boost::math::constants::pi<double>();
+  std::vector<double> osc_term(l_);
+  for(unsigned int site = 0; site < l_; ++site)
+    osc_term[site] = cos(2 * pi * beta_ * site);
+
+  PetscScalar *interaction, *on_site;
+  VecGetArray(InteractionDiag, &interaction);
+  VecGetArray(OnSiteDiag, &on_site);
+  for(PetscInt state = start_; state < end_; ++state){
+    State bs = int_basis[state - basis_start_];
+    interaction[state - start_] = static_cast<double> (sector_.interaction(bs));
+    double occupation = 0.0;
+    for(unsigned int site = 0; site < l_; ++site)
+      occupation += osc_term[site] * sector_.occupation(bs, site);
+    on_site[state - start_] = occupation;
+  }
+  VecRestoreArray(InteractionDiag, &interaction);
+  VecRestoreArray(OnSiteDiag, &on_site);
+
+  Log::stage_pop();
+}
+
+/*******************************************************************************/
+// The off-diagonal entries of the Hamiltonian are the hopping terms scaled by
+// t, since a hop never maps an element onto itself. They are kept in HamMat
+// and rescaled there, so only the diagonal parts are needed
+/*******************************************************************************/
+void SparseOp::construct_parts(State *int_basis)
+{
+  if(t_ == 0.0){
+    std::cerr << "The Hamiltonian can only be split if constructed with a non-zero hopping" 
+      << std::endl;
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+
+  construct_diagonals(int_basis);
+}
+
+/*******************************************************************************/
+// Scaling the whole matrix by t / t_ gives the new hopping terms, the diagonal
+// is then overwritten. A zero hopping can't be scaled back, so the values of
+// HamMat are stashed while t = 0
+/*******************************************************************************/
+void SparseOp::update_coefficients(double V, double t, double h)
+{
+  if(t != 0.0){
+    if(!hop_stash_.empty()) stash_values_(false);
+    MatScale(HamMat, t / t_);
+    t_ = t;
+  }
+  else{
+    if(hop_stash_.empty()) stash_values_(true);
+    MatScale(HamMat, 0.0);
+  }
+  VecAXPBYPCZ(diag_work_, V, h, 0.0, InteractionDiag, OnSiteDiag);
+  MatDiagonalSet(HamMat, diag_work_, INSERT_VALUES);
+}
+
+void SparseOp::shift_coefficients(double dV, double dh)
+{
+  VecAXPBYPCZ(diag_work_, dV, dh, 0.0, InteractionDiag, OnSiteDiag);
+  MatDiagonalSet(HamMat, diag_work_, ADD_VALUES);
+}
+
+void SparseOp::destroy_parts_()
+{
+  std::vector<PetscScalar>().swap(hop_stash_);
+  VecDestroy(&InteractionDiag);
+  VecDestroy(&OnSiteDiag);
+  VecDestroy(&diag_work_);
+}
+
+void SparseOp::reorder_vec_(Vec &vec)
+{
+  Vec reordered;
+  VecScatter scatter;
+  PetscInt nlocal;
+
+  ISGetLocalSize(RowOrdering, &nlocal);
+  VecCreateMPI(comm_, nlocal, basis_size_, &reordered);
+  VecScatterCreate(vec, RowOrdering, reordered, NULL, &scatter);
+  VecScatterBegin(scatter, vec, reordered, INSERT_VALUES, SCATTER_FORWARD);
+  VecScatterEnd(scatter, vec, reordered, INSERT_VALUES, SCATTER_FORWARD);
+  VecScatterDestroy(&scatter);
+
+  VecDestroy(&vec);
+  vec = reordered;
+}
+
+/*******************************************************************************/
+// The values of both local blocks of HamMat, in their storage order
+/*******************************************************************************/
+void SparseOp::stash_values_(bool save)
+{
+  Mat blocks[2];
+  MatMPIAIJGetSeqAIJ(HamMat, &blocks[0], &blocks[1], NULL);
+
+  PetscInt pos = 0;
+  for(int b = 0; b < 2; ++b){
+    MatInfo info;
+    PetscScalar *values;
+    MatGetInfo(blocks[b], MAT_LOCAL, &info);
+    PetscInt nz = static_cast<PetscInt> (info.nz_used);
+
+    MatSeqAIJGetArray(blocks[b], &values);
+    if(save) hop_stash_.insert(hop_stash_.end(), values, values + nz);
+    else std::copy(hop_stash_.begin() + pos, hop_stash_.begin() + pos + nz, values);
+    MatSeqAIJRestoreArray(blocks[b], &values);
+    pos += nz;
+  }
+
+  if(!save) std::vector<PetscScalar>().swap(hop_stash_);
+}
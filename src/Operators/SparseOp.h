@@ -0,0 +1,232 @@
+/** @addtogroup Core
+ * @{
+ */
+/**
+ * \class SparseOp.
+ * \ingroup Core
+ * \brief Related to the matrix representation of the Hamiltonian of the quantum system.
+ *
+ * The Hamiltonian matrix itself is a public member of this class and is row-wise distributed among
+ * processing elements. The row-wise distribution of the matrix is the same for every lookup
+ * policy, the only difference is the way the global indices of the basis elements that are not
+ * held locally are found (see Environment::LookupPolicy). See Section 3.1 of the manuscript in
+ * /docs for more details.
+ */
+#ifndef __SPARSEOP_H
+#define __SPARSEOP_H
+
+#include "../Environment/Environment.h"
+#include "../Utils/Utils.h"
+#include "../Basis/Basis.h"
+#include "../Log/Log.h"
+
+class SparseOp
+{
+  public:
+    /** \brief Creates an instance of class SparseOp.
+      * \param env An instance of the class Environment.
+      * \param basis An instance of the class Basis.
+      *
+      * This is the only available constructor of this class. After creating an instance of this class
+      * one can call the construct_AA_hamiltonian(...) method to introduce parameters into the matrix
+      * The matrix itself is a public member of the class, row-wise distributed across processing 
+      * elements. Please refer to Figure 1 and Section 3 (Hamiltonian matrix construction) of the 
+      * manuscript in /docs for more information.
+      */
+    SparseOp(const Environment &env, 
+             const Basis &basis);
+    /** \brief Destructor.
+      * 
+      * Deallocates and destroys the Hamiltonian matrix, no need to call MatDestroy() on the matrix. 
+      */ 
+    ~SparseOp();
+    /// Copy constructor.
+    SparseOp(const SparseOp &rhs);
+    /// Overloading of the assignment operator.
+    SparseOp &operator=(const SparseOp &rhs);
+    /** \brief Allocates memory and inserts elements to Hamiltonian matrix.
+      * 
+      * This should be called after creating an instance of SparseOp and before using time-evolution
+      * routines. The member HamMat is a matrix of type MATMPIAIJ from PETSc, for which memory is 
+      * preallocated, distributed and elements are added by this routine. Unless the memory budget
+      * of -assembly_buffer_mb is exceeded, the matrix is created directly from CSR arrays. The
+      * main communication described in Algorithm 5 and Section 3.1 in the manuscript located
+      * in /docs is used in this routine, for the node and ring lookup policies.
+      */
+    void construct_AA_hamiltonian(State *int_basis, 
+                                  double V,
+                                  double t, 
+                                  double h,
+                                  double beta);
+    /** \brief Reorders the rows and columns of the Hamiltonian matrix to reduce communication.
+      * 
+      * Should be called after construct_AA_hamiltonian(). A partitioning of the adjacency graph
+      * of HamMat is computed by PETSc's MatPartitioning (select the partitioner with
+      * -mat_partitioning_type, e.g. parmetis or ptscotch) and the matrix is redistributed 
+      * accordingly. The number of neighbouring processes and the size of the ghost vector used
+      * by MatMult are printed to stdout before and after the reordering. The permutation is 
+      * kept in RowOrdering, vectors in the basis order have to be mapped onto the new layout
+      * with it (see InitialState::reorder_rows()).
+      */
+    void reorder_rows();
+    /** \brief Splits the Hamiltonian into its parts, for time-dependent coefficients.
+      * \param int_basis Integer representation of the basis, as given to construct_AA_hamiltonian().
+      * 
+      * Should be called after construct_AA_hamiltonian(), with a non-zero hopping amplitude, and
+      * before reorder_rows(), which then reorders the parts as well. The hopping part is the
+      * off-diagonal part of HamMat itself, which is rescaled in place, so no second matrix is
+      * stored and no basis element is looked up again. The interaction and on-site parts are
+      * diagonal and kept as vectors.
+      */
+    void construct_parts(State *int_basis);
+    /** \brief Computes only the diagonal parts of the Hamiltonian, see construct_parts().
+      * \param int_basis Integer representation of the basis, as given to construct_AA_hamiltonian().
+      *
+      * Enough for changes of V and h, e.g. a quench, without a second copy of the hopping terms.
+      */
+    void construct_diagonals(State *int_basis);
+    /** \brief Sets new coefficients of the parts, HamMat = t Hop + diag(V InteractionDiag + h OnSiteDiag).
+      * \param V Interaction strength.
+      * \param t Hopping amplitude.
+      * \param h Strength of the quasi-periodic potential, with the frequency of the construction.
+      * 
+      * Requires construct_parts(). HamMat is scaled by the ratio of the new and the current hopping
+      * and its diagonal is rewritten, which takes a pass over the local entries and no
+      * communication, so HamMat can be updated at every step of a time-dependent evolution and
+      * solvers that refer to it see the new values. While t = 0 the previous values are stashed.
+      */
+    void update_coefficients(double V,
+                             double t,
+                             double h);
+    /** \brief Changes the interaction and potential strengths of HamMat in place.
+      * \param dV Change of the interaction strength.
+      * \param dh Change of the strength of the quasi-periodic potential.
+      *
+      * Requires construct_diagonals() or construct_parts(). Only the diagonal entries are updated,
+      * the hopping terms of HamMat are kept.
+      */
+    void shift_coefficients(double dV,
+                            double dh);
+    Mat HamMat; ///< The Hamiltonian matrix, row-wise distributed. PETSc MATMPIAIJ object.
+    IS RowOrdering; ///< Global basis index of each locally owned row after reorder_rows(), NULL otherwise.
+    Vec InteractionDiag; ///< Interaction part (V = 1), diagonal in the layout of HamMat, or NULL.
+    Vec OnSiteDiag; ///< Quasi-periodic potential part (h = 1), diagonal in the layout of HamMat, or NULL.
+
+  private:
+    unsigned int l_; ///< Number of sites.
+    unsigned int n_; ///< Subspace descriptor.
+    PetscMPIInt mpirank_; ///< Index of the local processor.
+    PetscMPIInt mpisize_; ///< Total number of processors.
+    MPI_Comm comm_; ///< Communicator of the group of the process.
+    PetscMPIInt node_rank_; ///< Local rank to specific node
+    PetscMPIInt node_size_; ///< Number of processing elements in node
+    MPI_Comm node_comm_; ///< The node MPI communicator
+    LLInt basis_size_; ///< Dimension of the Hilbert space.
+    PetscInt basis_local_; ///< Number of basis elements held locally, see Basis::basis_local.
+    PetscInt basis_start_; ///< Global index of the first basis element held locally.
+    PetscInt nlocal_; ///< Local amount of rows owned by processor (PETSc).
+    PetscInt start_; ///< Global index (PETSc).
+    PetscInt end_; ///< Global index (PETSc).
+    PetscReal assembly_buffer_mb_; ///< Memory budget of the staging buffer (MB), negative if unlimited.
+    Environment::LookupPolicy lookup_policy_; ///< How the non-local basis elements are resolved.
+    double t_; ///< Hopping amplitude of the off-diagonal entries of HamMat, or the last non-zero one.
+    double beta_; ///< Frequency of the quasi-periodic potential of the last construction.
+    Vec diag_work_; ///< Diagonal of update_coefficients().
+    std::vector<PetscScalar> hop_stash_; ///< Local values of HamMat while the hopping is zero.
+    Sector sector_; ///< Encoding of the basis elements and their hops.
+    PetscInt *d_i_; ///< Row offsets of the local diagonal block (CSR), owned by this class.
+    PetscInt *d_j_; ///< Local column indices of the diagonal block (CSR).
+    PetscScalar *d_a_; ///< Values of the diagonal block (CSR).
+    PetscInt *o_i_; ///< Row offsets of the off-diagonal block (CSR).
+    PetscInt *o_j_; ///< Global column indices of the off-diagonal block (CSR).
+    PetscScalar *o_a_; ///< Values of the off-diagonal block (CSR).
+    /** \brief A communication routine, wrapper to MPI_Allgather.
+      * 
+      * Section 3.1 and Algorithm 5 of the document in /docs for more details 
+      */
+    void gather_nonlocal_values_(LLInt *start_inds);
+    /** \brief Creates the Hamiltonian matrix from the staged column indices.
+      * 
+      * Used by construct_AA_hamiltonian() when the staging buffer fits in the memory budget.
+      * row_ptr and staging hold, in CSR form, the global column index of every hopping term
+      * of the locally owned rows, as resolved by determine_allocation_details_(), and diag/off
+      * the amount of entries per row of each block. The local diagonal and off-diagonal blocks
+      * are built as sorted CSR arrays and handed to MatCreateMPIAIJWithSplitArrays(), bypassing
+      * MatSetValues() and the assembly.
+      */
+    void create_csr_matrix_(State *int_basis,
+                            PetscInt *row_ptr,
+                            PetscInt *staging,
+                            PetscInt *diag,
+                            PetscInt *off,
+                            double V,
+                            double t,
+                            double h,
+                            double beta);
+    /// Frees the CSR arrays used by HamMat, if it was created by create_csr_matrix_().
+    void destroy_csr_();
+    /// Destroys the parts of construct_parts(), if any.
+    void destroy_parts_();
+    /** \brief Copies the local values of HamMat to hop_stash_, or back.
+      * \param save If true, the values are stashed, otherwise restored and the stash is freed.
+      */
+    void stash_values_(bool save);
+    /// Redistributes a vector in the basis order onto the layout of RowOrdering.
+    void reorder_vec_(Vec &vec);
+    /** \brief Resolves the global indices of non-local basis elements through the node leader.
+      * \param int_basis Integer representation of the locally held basis elements.
+      * \param requests Sorted, unique non-local elements.
+      * \param indices Global index of every element of requests, of the same size.
+      *
+      * Node lookup policy. Each worker sends its requests to rank 0 of its node, which holds
+      * the full basis and replies with their global indices.
+      */
+    void resolve_by_node_(State *int_basis,
+                          const std::vector<State> &requests,
+                          std::vector<LLInt> &indices);
+    /** \brief Resolves the global indices of non-local basis elements around a ring.
+      * \param int_basis Integer representation of the locally held basis elements.
+      * \param requests Sorted, unique non-local elements.
+      * \param indices Global index of every element of requests, of the same size.
+      *
+      * Ring lookup policy. The basis sections are passed around a ring of all processes, every
+      * step resolving the requests that fall in the received section.
+      */
+    void resolve_by_ring_(State *int_basis,
+                          const std::vector<State> &requests,
+                          std::vector<LLInt> &indices);
+    /** \brief Resolves the global indices of non-local basis elements by ranking.
+      * \param requests Sorted, unique non-local elements.
+      * \param indices Global index of every element of requests, of the same size.
+      *
+      * Rank lookup policy. Since the basis is ordered
+      * lexicographically, the index follows from the element (see Sector::rank()),
+      * without any communication.
+      */
+    void resolve_by_ranking_(const std::vector<State> &requests,
+                             std::vector<LLInt> &indices);
+    /** \brief Computes the number of non-zero elements.
+      * 
+      * For good performance, the sparse matrix that represents the Hamiltonian of the system
+      * has to be preallocated in memory. This routine is called internally by contruct_AA_hamiltonian()
+      * to allocate memory for the matrix. The main communication procedure described in Section 3.1 
+      * and Algorithm 5 of the manuscript in /docs is implemented here. 
+      * If staging is not NULL, the resolved column index of every hopping term is also stored
+      * in it (CSR order), to be used by create_csr_matrix_().
+      */
+    void determine_allocation_details_(State *int_basis, 
+                                       std::vector<LLInt> &cont,
+                                       std::vector<LLInt> &st, 
+                                       PetscInt *diag, 
+                                       PetscInt *off,
+                                       PetscInt *staging);
+    /** \brief Reports the communication pattern of MatMult.
+      * \param label Name of the ordering, printed along with the statistics.
+      * 
+      * Prints the maximum and average number of neighbouring processes and of ghost
+      * vector entries, taken from the off-diagonal block of HamMat.
+      */
+    void communication_statistics_(const char *label);
+};
+#endif
+/** @}*/
@@ -0,0 +1,142 @@
+#include "Results.h"
+
+#include <string>
+
+/*******************************************************************************/
+// Single custom constructor for this class. The parameters are written before
+// any time step is set, so their dataset has no time dimension
+/*******************************************************************************/
+Results::Results(MPI_Comm comm,
+                 const char *filename,
+                 const std::vector<PetscReal> &parameters,
+                 const char *names)
+{
+#if !defined(PETSC_HAVE_HDF5)
+  std::cerr << "HDF5 output requires PETSc configured with HDF5" << std::endl;
+  MPI_Abort(PETSC_COMM_WORLD, 1);
+#else
+  MPI_Comm_rank(comm, &mpirank_);
+  steps_ = 0;
+  snapshots_ = 0;
+
+  Log::event_begin(Log::EVENT_OUTPUT);
+
+  PetscViewerHDF5Open(comm, filename, FILE_MODE_WRITE, &viewer_);
+
+  Vec params;
+  create_root_vec_(comm, parameters.size(), "parameters", &params);
+  if(mpirank_ == 0){
+    PetscScalar *a;
+    VecGetArray(params, &a);
+    for(std::size_t i = 0; i < parameters.size(); ++i) a[i] = parameters[i];
+    VecRestoreArray(params, &a);
+  }
+  VecView(params, viewer_);
+  VecDestroy(&params);
+  PetscViewerHDF5WriteAttribute(viewer_, "/parameters", "names", PETSC_STRING, names);
+
+  create_root_vec_(comm, 4, "observables", &row_);
+  create_root_vec_(comm, 1, "snapshot_time", &time_);
+
+  Log::event_end(Log::EVENT_OUTPUT);
+#endif
+}
+
+Results::~Results()
+{
+#if defined(PETSC_HAVE_HDF5)
+  VecDestroy(&row_);
+  VecDestroy(&time_);
+  PetscViewerDestroy(&viewer_);
+#endif
+}
+
+void Results::create_root_vec_(MPI_Comm comm, PetscInt size, const char *name, Vec *vec) const
+{
+  VecCreateMPI(comm, (mpirank_ == 0) ? size : 0, size, vec);
+  PetscObjectSetName((PetscObject) *vec, name);
+}
+
+/*******************************************************************************/
+// PETSc extends the dataset of the vector along its time dimension up to the
+// given step, with chunks of a single step
+/*******************************************************************************/
+void Results::write_step_(Vec vec, PetscInt step)
+{
+#if defined(PETSC_HAVE_HDF5)
+  PetscViewerHDF5SetTimestep(viewer_, step);
+  VecView(vec, viewer_);
+#endif
+}
+
+void Results::record(double time, double echo, LLInt krylov_its, double wall_time)
+{
+  Log::event_begin(Log::EVENT_OUTPUT);
+
+  if(mpirank_ == 0){
+    PetscScalar *a;
+    VecGetArray(row_, &a);
+    a[0] = time;
+    a[1] = echo;
+    a[2] = static_cast<PetscReal> (krylov_its);
+    a[3] = wall_time;
+    VecRestoreArray(row_, &a);
+  }
+  write_step_(row_, steps_);
+
+#if defined(PETSC_HAVE_HDF5)
+  // The attribute needs the dataset, which exists after the first step
+  if(steps_ == 0)
+    PetscViewerHDF5WriteAttribute(viewer_, "/observables", "columns", PETSC_STRING,
+      "time,loschmidt_echo,krylov_iterations,wall_time");
+#endif
+  ++steps_;
+
+  Log::event_end(Log::EVENT_OUTPUT);
+}
+
+void Results::snapshot(Vec state, double time, IS ordering)
+{
+  Log::event_begin(Log::EVENT_OUTPUT);
+
+  if(mpirank_ == 0){
+    PetscScalar *a;
+    VecGetArray(time_, &a);
+    a[0] = time;
+    VecRestoreArray(time_, &a);
+  }
+  write_step_(time_, snapshots_);
+
+  // A reordered state goes back to the basis order, so snapshots of any run and
+  // process count can be compared
+  if(ordering){
+    MPI_Comm comm;
+    Vec basis_state;
+    VecScatter scatter;
+    PetscInt size;
+
+    PetscObjectGetComm((PetscObject) state, &comm);
+    VecGetSize(state, &size);
+    VecCreateMPI(comm, PETSC_DECIDE, size, &basis_state);
+    VecScatterCreate(state, NULL, basis_state, ordering, &scatter);
+    VecScatterBegin(scatter, state, basis_state, INSERT_VALUES, SCATTER_FORWARD);
+    VecScatterEnd(scatter, state, basis_state, INSERT_VALUES, SCATTER_FORWARD);
+    VecScatterDestroy(&scatter);
+
+    PetscObjectSetName((PetscObject) basis_state, "state");
+    write_step_(basis_state, snapshots_);
+    VecDestroy(&basis_state);
+  }
+  else{
+    // The name of the dataset is the one of the vector, restored afterwards
+    const char *name;
+    PetscObjectGetName((PetscObject) state, &name);
+    std::string previous(name ? name : "");
+    PetscObjectSetName((PetscObject) state, "state");
+    write_step_(state, snapshots_);
+    PetscObjectSetName((PetscObject) state, previous.c_str());
+  }
+  ++snapshots_;
+
+  Log::event_end(Log::EVENT_OUTPUT);
+}
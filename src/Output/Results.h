@@ -0,0 +1,92 @@
+/** @addtogroup Core
+ * @{
+ */
+/**
+ * \class Results.
+ * \ingroup Core
+ * \brief Writes the time series of an evolution and snapshots of its state into an HDF5 file.
+ *
+ * Uses PETSc's HDF5 viewer (PETSc configured with --download-hdf5 or --with-hdf5, built with
+ * MPI), which opens the file with the MPI-IO driver of parallel HDF5 and writes every vector
+ * collectively, each process its own rows. The file holds:
+ * - /parameters: the parameters of the point, their names in the attribute "names".
+ * - /observables: one row per step, with time, Loschmidt echo, Krylov iterations of the step
+ *   and wall time of the step, named in the attribute "columns".
+ * - /state and /snapshot_time: the state vector and its time at every snapshot, in the order
+ *   of the basis even if the rows of the Hamiltonian have been reordered.
+ *
+ * The time series and the snapshots are chunked datasets with an unlimited time dimension,
+ * extended at every write. As PetscScalar is complex, every dataset has a trailing dimension
+ * of size 2 (real and imaginary parts).
+ */
+#ifndef __RESULTS_H
+#define __RESULTS_H
+
+#include <vector>
+
+#include "../Environment/Environment.h"
+#include "../Log/Log.h"
+
+#if defined(PETSC_HAVE_HDF5)
+#include <petscviewerhdf5.h>
+#endif
+
+class Results
+{
+  public:
+    /** \brief Creates the file and writes the parameters, collective.
+      * \param comm Communicator of the group, the one of the state vectors.
+      * \param filename Name of the file, overwritten if it exists.
+      * \param parameters Values of the parameters of the point.
+      * \param names Names of the parameters, comma separated.
+      *
+      * Aborts if PETSc has been configured without HDF5.
+      */
+    Results(MPI_Comm comm,
+            const char *filename,
+            const std::vector<PetscReal> &parameters,
+            const char *names);
+    /** \brief Destructor.
+      *
+      * Closes the file.
+      */
+    ~Results();
+    /** \brief Appends a step to the time series, collective.
+      * \param time Time of the step.
+      * \param echo Loschmidt echo.
+      * \param krylov_its Krylov iterations of the step.
+      * \param wall_time Wall time of the step, in seconds.
+      */
+    void record(double time,
+                double echo,
+                LLInt krylov_its,
+                double wall_time);
+    /** \brief Appends a snapshot of the state, collective.
+      * \param state The state, in the layout of the Hamiltonian.
+      * \param time Time of the snapshot.
+      * \param ordering Global basis index of each local entry of the state, i.e.
+      *                 SparseOp::RowOrdering, or NULL if the rows have not been reordered. The
+      *                 state is then scattered back to the order of the basis before it is written.
+      */
+    void snapshot(Vec state,
+                  double time,
+                  IS ordering = NULL);
+
+  private:
+    PetscViewer viewer_; ///< HDF5 viewer of the file.
+    Vec row_; ///< Observables of a step, held by the first process.
+    Vec time_; ///< Time of a snapshot, held by the first process.
+    PetscInt steps_; ///< Steps written so far.
+    PetscInt snapshots_; ///< Snapshots written so far.
+    PetscMPIInt mpirank_; ///< Rank of the process in the group.
+    /// Creates a named vector of the given size, whose entries are all held by the first process.
+    void create_root_vec_(MPI_Comm comm,
+                          PetscInt size,
+                          const char *name,
+                          Vec *vec) const;
+    /// Writes a vector as the given time step of its dataset.
+    void write_step_(Vec vec,
+                     PetscInt step);
+};
+#endif
+/** @}*/
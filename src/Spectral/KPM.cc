@@ -0,0 +1,215 @@
+#include "KPM.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <boost/math/constants/constants.hpp>
+
+/*******************************************************************************/
+// Single custom constructor for this class. The work vectors share the layout
+// of the matrix, also when its rows have been reordered
+/*******************************************************************************/
+KPM::KPM(const Mat &ham_mat,
+         PetscInt n_moments,
+         PetscReal margin)
+{
+  ham_mat_ = ham_mat;
+  PetscObjectGetComm((PetscObject) ham_mat, &comm_);
+  n_moments_ = std::max(n_moments, static_cast<PetscInt> (2));
+
+  MatCreateVecs(ham_mat_, &prev_, &cur_);
+  VecDuplicate(cur_, &work_);
+
+  spectral_bounds_(margin);
+}
+
+KPM::~KPM()
+{
+  VecDestroy(&prev_);
+  VecDestroy(&cur_);
+  VecDestroy(&work_);
+}
+
+/*******************************************************************************/
+// Extreme eigenvalues with a loose tolerance, the margin covers the error of
+// the Ritz values
+/*******************************************************************************/
+void KPM::spectral_bounds_(PetscReal margin)
+{
+  Log::stage_push(Log::STAGE_SPECTRAL);
+  Log::event_begin(Log::EVENT_BOUNDS);
+
+  Utils::spectral_bounds(ham_mat_, margin, e_min, e_max);
+  scale_ = 0.5 * (e_max - e_min);
+  shift_ = 0.5 * (e_max + e_min);
+
+  Log::event_end(Log::EVENT_BOUNDS);
+  Log::stage_pop();
+}
+
+void KPM::chebyshev_step_(bool first)
+{
+  MatMult(ham_mat_, cur_, work_);
+
+  if(first){
+    VecWAXPY(prev_, -shift_, cur_, work_);
+    VecScale(prev_, 1.0 / scale_);
+  }
+  else{
+    VecAXPBYPCZ(prev_, 2.0 / scale_, -2.0 * shift_ / scale_, -1.0, work_, cur_);
+  }
+  std::swap(prev_, cur_);
+}
+
+PetscScalar KPM::local_dot_(Vec x, Vec y) const
+{
+  PetscInt nlocal;
+  const PetscScalar *xa, *ya;
+  VecGetLocalSize(x, &nlocal);
+  VecGetArrayRead(x, &xa);
+  VecGetArrayRead(y, &ya);
+
+  PetscScalar dot = 0.0;
+  for(PetscInt i = 0; i < nlocal; ++i) dot += PetscConj(xa[i]) * ya[i];
+
+  VecRestoreArrayRead(x, &xa);
+  VecRestoreArrayRead(y, &ya);
+
+  return dot;
+}
+
+/*******************************************************************************/
+// Every random vector has entries exp(i phi) with uniform phases, so its norm
+// is exactly D. The phases are keyed on the basis index of the row and the
+// vector. The moments of all the vectors are accumulated locally, including
+// the T_0 and T_1 corrections of the doubling, and reduced at the end
+/*******************************************************************************/
+void KPM::dos_moments(PetscInt n_vectors,
+                      std::vector<PetscReal> &mu,
+                      unsigned int seed,
+                      IS ordering)
+{
+  Log::stage_push(Log::STAGE_SPECTRAL);
+  Log::event_begin(Log::EVENT_MOMENTS);
+
+  const double pi = boost::math::constants::pi<double>();
+
+  PetscInt dim, start, end;
+  VecGetSize(cur_, &dim);
+  VecGetOwnershipRange(cur_, &start, &end);
+
+  const PetscInt *index = NULL;
+  if(ordering) ISGetIndices(ordering, &index);
+
+  mu.assign(n_moments_, 0.0);
+  for(PetscInt r = 0; r < n_vectors; ++r){
+    PetscScalar *a;
+    VecGetArray(cur_, &a);
+    for(PetscInt i = start; i < end; ++i){
+      PetscReal u0, u1;
+      Utils::random_pair(index ? index[i - start] : i, r, seed, u0, u1);
+      a[i - start] = std::cos(2.0 * pi * u0) + PETSC_i * std::sin(2.0 * pi * u0);
+    }
+    VecRestoreArray(cur_, &a);
+
+    PetscReal mu0 = PetscRealPart(local_dot_(cur_, cur_));
+    chebyshev_step_(true);
+    PetscReal mu1 = PetscRealPart(local_dot_(prev_, cur_));
+    mu[0] += mu0;
+    mu[1] += mu1;
+    Log::count(Log::COUNTER_MATVECS, 1);
+
+    // cur_ holds T_n |r> and prev_ holds T_n-1 |r>
+    for(PetscInt n = 1; 2 * n < n_moments_; ++n){
+      mu[2 * n] += 2.0 * PetscRealPart(local_dot_(cur_, cur_)) - mu0;
+      if(2 * n + 1 < n_moments_){
+        chebyshev_step_(false);
+        mu[2 * n + 1] += 2.0 * PetscRealPart(local_dot_(prev_, cur_)) - mu1;
+        Log::count(Log::COUNTER_MATVECS, 1);
+      }
+    }
+  }
+
+  if(ordering) ISRestoreIndices(ordering, &index);
+
+  MPI_Allreduce(MPI_IN_PLACE, &mu[0], n_moments_, MPIU_REAL, MPI_SUM, comm_);
+  for(PetscInt n = 0; n < n_moments_; ++n) mu[n] /= static_cast<PetscReal> (n_vectors) * dim;
+
+  Log::event_end(Log::EVENT_MOMENTS);
+  Log::stage_pop();
+}
+
+void KPM::correlation_moments(Vec left, Vec right, std::vector<PetscScalar> &mu)
+{
+  Log::stage_push(Log::STAGE_SPECTRAL);
+  Log::event_begin(Log::EVENT_MOMENTS);
+
+  // Real and imaginary parts, reduced together
+  std::vector<PetscReal> parts(2 * n_moments_, 0.0);
+
+  VecCopy(right, cur_);
+  for(PetscInt n = 0; n < n_moments_; ++n){
+    if(n > 0){
+      chebyshev_step_(n == 1);
+      Log::count(Log::COUNTER_MATVECS, 1);
+    }
+    PetscScalar dot = local_dot_(left, cur_);
+    parts[2 * n] = PetscRealPart(dot);
+    parts[2 * n + 1] = PetscImaginaryPart(dot);
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE, &parts[0], 2 * n_moments_, MPIU_REAL, MPI_SUM, comm_);
+  mu.resize(n_moments_);
+  for(PetscInt n = 0; n < n_moments_; ++n) mu[n] = parts[2 * n] + PETSC_i * parts[2 * n + 1];
+
+  Log::event_end(Log::EVENT_MOMENTS);
+  Log::stage_pop();
+}
+
+/*******************************************************************************/
+// rho(E) = [g_0 mu_0 + 2 sum_n g_n mu_n T_n(x)] / (pi sqrt(1 - x^2) scale),
+// with x = (E - shift) / scale and g_n the Jackson kernel, which removes the
+// Gibbs oscillations of the truncated series
+/*******************************************************************************/
+void KPM::reconstruct(const std::vector<PetscReal> &mu,
+                      PetscInt n_points,
+                      std::vector<PetscReal> &energies,
+                      std::vector<PetscReal> &density) const
+{
+  const double pi = boost::math::constants::pi<double>();
+  PetscInt n_moments = mu.size();
+
+  std::vector<PetscReal> g;
+  Utils::jackson_kernel(n_moments, g);
+
+  energies.resize(n_points);
+  density.resize(n_points);
+  for(PetscInt k = 0; k < n_points; ++k){
+    double x = std::cos(pi * (n_points - k - 0.5) / n_points);
+    double theta = std::acos(x);
+
+    double sum = g[0] * mu[0];
+    for(PetscInt n = 1; n < n_moments; ++n) sum += 2.0 * g[n] * mu[n] * std::cos(n * theta);
+
+    energies[k] = scale_ * x + shift_;
+    density[k] = sum / (pi * std::sqrt(1.0 - x * x) * scale_);
+  }
+}
+
+PetscReal KPM::density(const std::vector<PetscReal> &mu, PetscReal energy) const
+{
+  const double pi = boost::math::constants::pi<double>();
+  PetscInt n_moments = mu.size();
+
+  std::vector<PetscReal> g;
+  Utils::jackson_kernel(n_moments, g);
+
+  double x = (energy - shift_) / scale_;
+  if(std::abs(x) >= 1.0) return 0.0;
+  double theta = std::acos(x);
+
+  double sum = g[0] * mu[0];
+  for(PetscInt n = 1; n < n_moments; ++n) sum += 2.0 * g[n] * mu[n] * std::cos(n * theta);
+
+  return sum / (pi * std::sqrt(1.0 - x * x) * scale_);
+}
@@ -0,0 +1,111 @@
+/** @addtogroup Core
+ * @{
+ */
+/**
+ * \class KPM.
+ * \ingroup Core
+ * \brief Kernel polynomial method, spectral densities from Chebyshev moments of the Hamiltonian.
+ *
+ * The Hamiltonian is rescaled into [-1, 1] with the spectral bounds, estimated by SLEPc's EPS,
+ * and the Chebyshev polynomials T_n of the rescaled operator are applied to vectors by their
+ * three-term recursion. The density of states follows from the moments Tr T_n / D, estimated
+ * stochastically with random phase vectors, and a dynamical correlation <a| delta(E - H) |b>
+ * from the moments <a| T_n |b>. The densities are reconstructed with the Jackson kernel.
+ * Only MatMult and a few vectors with the layout of the matrix are required, the moments
+ * are accumulated locally and reduced once at the end.
+ */
+#ifndef __KPM_H
+#define __KPM_H
+
+#include <vector>
+
+#include "../Environment/Environment.h"
+#include "../Log/Log.h"
+#include "../Utils/Utils.h"
+
+class KPM
+{
+  public:
+    /** \brief Creates an instance of class KPM, estimating the spectral bounds.
+      * \param ham_mat The Hamiltonian matrix, or any other Hermitian matrix object from PETSc.
+      * \param n_moments Number of Chebyshev moments, the energy resolution is about the
+      *                  width of the spectrum over n_moments.
+      * \param margin Relative margin added to the bounds, keeps the rescaled spectrum away from +-1.
+      *
+      * The extreme eigenvalues are computed with EPS (loose tolerance), the infinity norm of
+      * the matrix is used as bound if they fail to converge.
+      */
+    KPM(const Mat &ham_mat,
+        PetscInt n_moments,
+        PetscReal margin = 0.01);
+    /** \brief Destructor.
+      *
+      * Destroys the work vectors.
+      */
+    ~KPM();
+    /** \brief Moments of the density of states, by stochastic trace estimation.
+      * \param n_vectors Number of random phase vectors, the error decreases as 1/sqrt(n_vectors D).
+      * \param mu Moments Tr T_n / D, normalised such that mu[0] = 1.
+      * \param seed Seed of the random vectors, whose entries are keyed on the basis index of
+      *             the row, so the moments do not depend on the number of processes (up to
+      *             rounding).
+      * \param ordering Basis index of each local row, i.e. SparseOp::RowOrdering, or NULL if the
+      *                 rows follow the basis.
+      *
+      * Two moments are obtained per matrix-vector product from T_2n = 2 T_n T_n - T_0 and
+      * T_2n+1 = 2 T_n+1 T_n - T_1.
+      */
+    void dos_moments(PetscInt n_vectors,
+                     std::vector<PetscReal> &mu,
+                     unsigned int seed = 0,
+                     IS ordering = NULL);
+    /** \brief Moments of a dynamical correlation function.
+      * \param left The bra, e.g. A |psi>.
+      * \param right The ket, e.g. B |psi>.
+      * \param mu Moments <left| T_n |right>.
+      *
+      * With left = right = |psi> the density is the local density of states of |psi>, the
+      * Fourier transform of its return amplitude.
+      */
+    void correlation_moments(Vec left,
+                             Vec right,
+                             std::vector<PetscScalar> &mu);
+    /** \brief Reconstructs a density from its moments with the Jackson kernel.
+      * \param mu Real moments, from dos_moments() or the real part of correlation_moments().
+      * \param n_points Number of energies, on the Chebyshev nodes of the rescaled spectrum.
+      * \param energies Energies, in increasing order.
+      * \param density Density at every energy, per unit of energy.
+      */
+    void reconstruct(const std::vector<PetscReal> &mu,
+                     PetscInt n_points,
+                     std::vector<PetscReal> &energies,
+                     std::vector<PetscReal> &density) const;
+    /** \brief Density at a single energy, reconstructed with the Jackson kernel.
+      * \param mu Real moments, as for reconstruct().
+      * \param energy The energy, zero outside of the spectral bounds.
+      * \return Density per unit of energy.
+      */
+    PetscReal density(const std::vector<PetscReal> &mu,
+                      PetscReal energy) const;
+    PetscReal e_min; ///< Lower spectral bound.
+    PetscReal e_max; ///< Upper spectral bound.
+
+  private:
+    Mat ham_mat_; ///< The Hamiltonian matrix, not owned.
+    MPI_Comm comm_; ///< Communicator of the matrix.
+    PetscInt n_moments_; ///< Number of Chebyshev moments.
+    PetscReal scale_; ///< Half width of the rescaled spectrum, H = scale_ x + shift_.
+    PetscReal shift_; ///< Centre of the spectrum.
+    Vec prev_; ///< Previous vector of the recursion.
+    Vec cur_; ///< Current vector of the recursion.
+    Vec work_; ///< Product of the matrix with the current vector.
+    /// Estimates e_min and e_max, and sets the rescaling.
+    void spectral_bounds_(PetscReal margin);
+    /// Replaces prev_ with 2 H' cur_ - prev_ (or H' cur_ if first), H' the rescaled matrix.
+    void chebyshev_step_(bool first);
+    /// Local part of the dot product <x|y>, reduced by the caller.
+    PetscScalar local_dot_(Vec x,
+                           Vec y) const;
+};
+#endif
+/** @}*/
@@ -0,0 +1,230 @@
+#include "Polfed.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <petscblaslapack.h>
+#include <boost/math/constants/constants.hpp>
+
+/*******************************************************************************/
+// The shell matrix carries the instance as context, its size and layout are
+// those of the Hamiltonian
+/*******************************************************************************/
+Polfed::Polfed(const Mat &ham_mat,
+               PetscReal e_min,
+               PetscReal e_max)
+{
+  ham_mat_ = ham_mat;
+  PetscObjectGetComm((PetscObject) ham_mat, &comm_);
+  scale_ = 0.5 * (e_max - e_min);
+  shift_ = 0.5 * (e_max + e_min);
+
+  MatCreateVecs(ham_mat_, &prev_, &cur_);
+  VecDuplicate(cur_, &work_);
+
+  PetscInt m, n, M, N;
+  MatGetLocalSize(ham_mat_, &m, &n);
+  MatGetSize(ham_mat_, &M, &N);
+  MatCreateShell(comm_, m, n, M, N, this, &filter_);
+  MatShellSetOperation(filter_, MATOP_MULT, (void (*)(void)) filter_mult_);
+}
+
+Polfed::~Polfed()
+{
+  destroy_eigenvectors_();
+  MatDestroy(&filter_);
+  VecDestroy(&prev_);
+  VecDestroy(&cur_);
+  VecDestroy(&work_);
+}
+
+PetscInt Polfed::filter_order(PetscReal density, PetscInt nev) const
+{
+  const double pi = boost::math::constants::pi<double>();
+
+  PetscInt dim;
+  VecGetSize(cur_, &dim);
+
+  // Eigenvalues within +-pi scale / order of the target
+  double order = 2.0 * pi * scale_ * density * dim / std::max(nev, static_cast<PetscInt> (1));
+  return std::max(static_cast<PetscInt> (std::ceil(order)), static_cast<PetscInt> (16));
+}
+
+/*******************************************************************************/
+// Chebyshev expansion of delta(x - x0), c_k = (2 - delta_k0) g_k T_k(x0), with
+// the Jackson kernel g_k. Dividing by P(x0) keeps the largest eigenvalues of
+// the filter around one
+/*******************************************************************************/
+void Polfed::set_filter_(PetscReal target, PetscInt order)
+{
+  double x0 = std::max(-1.0, std::min(1.0, (target - shift_) / scale_));
+  double theta = std::acos(x0);
+
+  std::vector<PetscReal> g;
+  Utils::jackson_kernel(order + 1, g);
+
+  coeffs_.resize(order + 1);
+  double norm = 0.0;
+  for(PetscInt k = 0; k <= order; ++k){
+    coeffs_[k] = ((k == 0) ? 1.0 : 2.0) * g[k] * std::cos(k * theta);
+    norm += coeffs_[k] * std::cos(k * theta);
+  }
+  for(PetscInt k = 0; k <= order; ++k) coeffs_[k] /= norm;
+}
+
+void Polfed::apply_filter_(Vec x, Vec y)
+{
+  // cur_ holds T_k |x> and prev_ holds T_k-1 |x>, y accumulates the series
+  VecCopy(x, cur_);
+  VecCopy(x, y);
+  VecScale(y, coeffs_[0]);
+  for(std::size_t k = 1; k < coeffs_.size(); ++k){
+    MatMult(ham_mat_, cur_, work_);
+    if(k == 1){
+      VecWAXPY(prev_, -shift_, cur_, work_);
+      VecScale(prev_, 1.0 / scale_);
+    }
+    else{
+      VecAXPBYPCZ(prev_, 2.0 / scale_, -2.0 * shift_ / scale_, -1.0, work_, cur_);
+    }
+    std::swap(prev_, cur_);
+    VecAXPY(y, coeffs_[k], cur_);
+  }
+
+  Log::count(Log::COUNTER_MATVECS, coeffs_.size() - 1);
+}
+
+PetscErrorCode Polfed::filter_mult_(Mat filter, Vec x, Vec y)
+{
+  Polfed *polfed;
+  MatShellGetContext(filter, &polfed);
+  polfed->apply_filter_(x, y);
+  return 0;
+}
+
+void Polfed::solve(PetscReal target, PetscInt nev, PetscInt order)
+{
+  Log::stage_push(Log::STAGE_SPECTRAL);
+  Log::event_begin(Log::EVENT_POLFED);
+
+  set_filter_(target, order);
+
+  EPS eps;
+  EPSCreate(comm_, &eps);
+  EPSSetOperators(eps, filter_, NULL);
+  EPSSetProblemType(eps, EPS_HEP);
+  EPSSetType(eps, EPSKRYLOVSCHUR);
+  EPSSetWhichEigenpairs(eps, EPS_LARGEST_REAL);
+  EPSSetDimensions(eps, nev, PETSC_DEFAULT, PETSC_DEFAULT);
+  EPSSetOptionsPrefix(eps, "polfed_");
+  EPSSetFromOptions(eps);
+  EPSSolve(eps);
+
+  PetscInt nconv;
+  EPSGetConverged(eps, &nconv);
+  if(nconv < 1){
+    std::cerr << "Filtered eigensolver did not converge, aborting" << std::endl;
+    std::cerr << "Change the filter order or the solver options (-polfed_eps_*)" << std::endl;
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+
+  std::vector<Vec> basis(nconv);
+  for(PetscInt i = 0; i < nconv; ++i){
+    MatCreateVecs(ham_mat_, NULL, &basis[i]);
+    EPSGetEigenvector(eps, i, basis[i], NULL);
+  }
+  EPSDestroy(&eps);
+
+  Log::event_end(Log::EVENT_POLFED);
+
+  rayleigh_ritz_(basis);
+
+  // Keeps the nev Ritz pairs closest to the target, in increasing order of energy
+  std::vector<std::pair<PetscReal, PetscInt> > distance(nconv);
+  for(PetscInt i = 0; i < nconv; ++i)
+    distance[i] = std::make_pair(std::abs(eigenvalues[i] - target), i);
+  std::sort(distance.begin(), distance.end());
+
+  std::vector<PetscInt> keep;
+  for(PetscInt i = 0; i < std::min(nev, nconv); ++i) keep.push_back(distance[i].second);
+  std::sort(keep.begin(), keep.end());
+
+  destroy_eigenvectors_();
+  std::vector<PetscReal> values(eigenvalues), res(residuals);
+  eigenvalues.clear();
+  residuals.clear();
+  for(std::size_t i = 0; i < keep.size(); ++i){
+    eigenvalues.push_back(values[keep[i]]);
+    residuals.push_back(res[keep[i]]);
+    eigenvectors.push_back(basis[keep[i]]);
+    basis[keep[i]] = NULL;
+  }
+  for(PetscInt i = 0; i < nconv; ++i) if(basis[i]) VecDestroy(&basis[i]);
+
+  Log::stage_pop();
+}
+
+/*******************************************************************************/
+// G = V^H H V is diagonalised by LAPACK on every process, the Ritz vectors are
+// the columns of V Z. The eigenvalues of LAPACK come in increasing order
+/*******************************************************************************/
+void Polfed::rayleigh_ritz_(std::vector<Vec> &basis)
+{
+  Log::event_begin(Log::EVENT_RITZ);
+
+  PetscInt n = basis.size();
+
+  std::vector<PetscScalar> proj(n * n);
+  for(PetscInt j = 0; j < n; ++j){
+    MatMult(ham_mat_, basis[j], work_);
+    VecMDot(work_, n, &basis[0], &proj[j * n]);
+  }
+  Log::count(Log::COUNTER_MATVECS, n);
+
+  PetscBLASInt bn, lwork, info;
+  PetscBLASIntCast(n, &bn);
+  PetscBLASIntCast(std::max(static_cast<PetscInt> (1), 2 * n), &lwork);
+  std::vector<PetscScalar> work(lwork);
+  std::vector<PetscReal> rwork(std::max(static_cast<PetscInt> (1), 3 * n - 2));
+  eigenvalues.resize(n);
+  LAPACKheev_("V", "U", &bn, &proj[0], &bn, &eigenvalues[0], &work[0], &lwork, &rwork[0], &info);
+  if(info != 0){
+    std::cerr << "Rayleigh-Ritz projection failed, aborting" << std::endl;
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+
+  std::vector<Vec> ritz(n);
+  residuals.resize(n);
+  for(PetscInt k = 0; k < n; ++k){
+    VecDuplicate(basis[0], &ritz[k]);
+    VecSet(ritz[k], 0.0);
+    VecMAXPY(ritz[k], n, &proj[k * n], &basis[0]);
+
+    MatMult(ham_mat_, ritz[k], work_);
+    VecAXPY(work_, -eigenvalues[k], ritz[k]);
+    VecNorm(work_, NORM_2, &residuals[k]);
+  }
+  Log::count(Log::COUNTER_MATVECS, n);
+
+  for(PetscInt k = 0; k < n; ++k){
+    VecDestroy(&basis[k]);
+    basis[k] = ritz[k];
+  }
+
+  Log::event_end(Log::EVENT_RITZ);
+}
+
+void Polfed::write_eigenvectors(const char *filename, bool append) const
+{
+  PetscViewer viewer;
+  PetscViewerBinaryOpen(comm_, filename, append ? FILE_MODE_APPEND : FILE_MODE_WRITE, &viewer);
+  for(std::size_t i = 0; i < eigenvectors.size(); ++i) VecView(eigenvectors[i], viewer);
+  PetscViewerDestroy(&viewer);
+}
+
+void Polfed::destroy_eigenvectors_()
+{
+  for(std::size_t i = 0; i < eigenvectors.size(); ++i) VecDestroy(&eigenvectors[i]);
+  eigenvectors.clear();
+}
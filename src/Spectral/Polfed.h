@@ -0,0 +1,106 @@
+/** @addtogroup Core
+ * @{
+ */
+/**
+ * \class Polfed.
+ * \ingroup Core
+ * \brief Polynomially filtered eigensolver, eigenpairs of the Hamiltonian close to a target energy.
+ *
+ * Interior eigenpairs, e.g. in the middle of the spectrum for many-body localisation, usually
+ * require shift-and-invert, whose distributed factorisation does not fit in memory for large
+ * Hilbert spaces. Here the Hamiltonian H is replaced by a polynomial P(H), a Chebyshev expansion
+ * of a delta function at the target damped with the Jackson kernel, whose largest eigenvalues
+ * belong to the eigenvectors of H closest to the target. P(H) is a shell matrix applied by the
+ * three-term recursion, so only MatMult is required, and its largest eigenvalues are computed
+ * with SLEPc's Krylov-Schur. The converged vectors are finally rotated by a Rayleigh-Ritz
+ * projection onto H, which separates eigenvectors of H that P maps to nearly the same value.
+ */
+#ifndef __POLFED_H
+#define __POLFED_H
+
+#include <vector>
+
+#include "../Environment/Environment.h"
+#include "../Log/Log.h"
+#include "../Utils/Utils.h"
+
+class Polfed
+{
+  public:
+    /** \brief Creates an instance of class Polfed.
+      * \param ham_mat The Hamiltonian matrix, or any other Hermitian matrix object from PETSc.
+      * \param e_min Lower spectral bound, e.g. from class KPM.
+      * \param e_max Upper spectral bound.
+      */
+    Polfed(const Mat &ham_mat,
+           PetscReal e_min,
+           PetscReal e_max);
+    /** \brief Destructor.
+      *
+      * Destroys the filter, the work vectors and the eigenvectors.
+      */
+    ~Polfed();
+    /** \brief Order of the filter for a number of eigenpairs around the target.
+      * \param density Density of states at the target, per unit of energy and normalised to one,
+      *                e.g. from KPM::density().
+      * \param nev Number of eigenpairs.
+      * \return Order of the polynomial, at least 16.
+      *
+      * The filter has a width of about pi scale / order around the target, which should hold
+      * about nev eigenvalues.
+      */
+    PetscInt filter_order(PetscReal density,
+                          PetscInt nev) const;
+    /** \brief Computes the eigenpairs closest to a target energy.
+      * \param target The target energy, within the spectral bounds.
+      * \param nev Number of eigenpairs.
+      * \param order Order of the polynomial filter.
+      *
+      * The eigenvalues (in increasing order), residuals and eigenvectors replace those of
+      * the previous call. The solver can be configured with the options prefix -polfed_,
+      * e.g. -polfed_eps_tol or -polfed_eps_ncv. Fewer eigenpairs are kept if the solver
+      * does not converge all of them.
+      */
+    void solve(PetscReal target,
+               PetscInt nev,
+               PetscInt order);
+    /** \brief Writes the eigenvectors of the last solve() into a PETSc binary file.
+      * \param filename Name of the file.
+      * \param append Appends to the file instead of overwriting it, to write several batches.
+      *
+      * The vectors, one per eigenvalue, can be read back with VecLoad(). Their entries follow
+      * the rows of the matrix, i.e. the reordered basis if the rows have been reordered.
+      */
+    void write_eigenvectors(const char *filename,
+                            bool append) const;
+    std::vector<PetscReal> eigenvalues; ///< Eigenvalues of the last solve(), in increasing order.
+    std::vector<PetscReal> residuals; ///< Residual norms ||H v - E v|| of the eigenvectors.
+    std::vector<Vec> eigenvectors; ///< Normalised eigenvectors of the last solve().
+
+  private:
+    Mat ham_mat_; ///< The Hamiltonian matrix, not owned.
+    Mat filter_; ///< Shell matrix of the polynomial filter.
+    MPI_Comm comm_; ///< Communicator of the matrix.
+    PetscReal scale_; ///< Half width of the rescaled spectrum, H = scale_ x + shift_.
+    PetscReal shift_; ///< Centre of the spectrum.
+    std::vector<PetscReal> coeffs_; ///< Chebyshev coefficients of the filter.
+    Vec prev_; ///< Previous vector of the recursion.
+    Vec cur_; ///< Current vector of the recursion.
+    Vec work_; ///< Product of the matrix with the current vector.
+    /// Sets the coefficients of the filter, normalised to one at the target.
+    void set_filter_(PetscReal target,
+                     PetscInt order);
+    /// Applies the filter, y = P(H) x.
+    void apply_filter_(Vec x,
+                       Vec y);
+    /// MatMult of the shell matrix, calls apply_filter_() of the instance in its context.
+    static PetscErrorCode filter_mult_(Mat filter,
+                                       Vec x,
+                                       Vec y);
+    /// Rayleigh-Ritz projection of H onto the vectors, replaces them with the Ritz vectors.
+    void rayleigh_ritz_(std::vector<Vec> &basis);
+    /// Destroys the eigenvectors.
+    void destroy_eigenvectors_();
+};
+#endif
+/** @}*/
@@ -0,0 +1,74 @@
+#include "DrivenEvo.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <boost/math/constants/constants.hpp>
+
+DrivenEvo::DrivenEvo(SparseOp &ham,
+                     KrylovEvo &te,
+                     double V,
+                     double t,
+                     double h,
+                     double t_amp,
+                     double h_amp,
+                     double omega,
+                     PetscInt resolution) : ham_(ham), te_(te)
+{
+  V_ = V;
+  t_ = t;
+  h_ = h;
+  t_amp_ = t_amp;
+  h_amp_ = h_amp;
+  omega_ = omega;
+  resolution_ = std::max(resolution, static_cast<PetscInt> (1));
+}
+
+/*******************************************************************************/
+// Without drive a single exponential of the static Hamiltonian is exact, and
+// the two exponentials of a step commute
+/*******************************************************************************/
+void DrivenEvo::driven_evo(const double &final_time,
+                           const double &initial_time,
+                           Vec &vec)
+{
+  const double pi = boost::math::constants::pi<double>();
+  double length = final_time - initial_time;
+
+  PetscInt steps = 1;
+  if(omega_ != 0.0){
+    double period = 2 * pi / std::abs(omega_);
+    steps = static_cast<PetscInt> (std::ceil(std::abs(length) * resolution_ / period - 1.0e-9));
+    steps = std::max(steps, static_cast<PetscInt> (1));
+  }
+
+  double dt = length / steps;
+  double c = std::sqrt(3.0) / 6.0;
+  for(PetscInt k = 0; k < steps; ++k){
+    double s = initial_time + k * dt;
+    double s_1 = s + (0.5 - c) * dt;
+    double s_2 = s + (0.5 + c) * dt;
+
+    // The exponential with more weight at the earlier time acts first
+    exponential_(s_1, 0.25 + c, s_2, 0.25 - c, dt, vec);
+    exponential_(s_1, 0.25 - c, s_2, 0.25 + c, dt, vec);
+  }
+}
+
+/*******************************************************************************/
+// The weights add up to 1/2, the Hamiltonian of the exponential is their
+// normalised average and the elapsed time dt / 2
+/*******************************************************************************/
+void DrivenEvo::exponential_(double s_1,
+                             double w_1,
+                             double s_2,
+                             double w_2,
+                             double dt,
+                             Vec &vec)
+{
+  double w = w_1 + w_2;
+  double drive = (w_1 * std::cos(omega_ * s_1) + w_2 * std::cos(omega_ * s_2)) / w;
+
+  ham_.update_coefficients(V_, t_ + t_amp_ * drive, h_ + h_amp_ * drive);
+  te_.krylov_evo(w * dt, 0.0, vec);
+}
@@ -0,0 +1,80 @@
+/** @addtogroup Core
+ * @{
+ */
+/**
+ * \class DrivenEvo.
+ * \ingroup Core
+ * \brief Time evolution with periodically driven hopping and quasi-periodic potential.
+ *
+ * The Hamiltonian H(s) = t(s) H_t + V H_V + h(s) H_h, with t(s) = t + a_t cos(w s) and
+ * h(s) = h + a_h cos(w s), is evolved with the fourth order commutator-free Magnus
+ * propagator (Blanes and Moan). A step of length dt is the product of two exponentials,
+ * exp(i dt (a_1 H(s_1) + a_2 H(s_2))) exp(i dt (a_2 H(s_1) + a_1 H(s_2))), with
+ * s_1,2 = s + (1/2 -+ sqrt(3)/6) dt and a_1,2 = 1/4 -+ sqrt(3)/6, both applied by KrylovEvo.
+ * Since H(s) is linear in its coefficients, every exponential needs a single Hamiltonian with
+ * averaged coefficients, which SparseOp::update_coefficients() writes into the nonzero
+ * pattern of HamMat from the parts of SparseOp::construct_parts(). No commutators and no
+ * reassembly are required.
+ */
+#ifndef __DRIVEN_EVO_H
+#define __DRIVEN_EVO_H
+
+#include "../Environment/Environment.h"
+#include "../Operators/SparseOp.h"
+#include "KrylovEvo.h"
+
+class DrivenEvo
+{
+  public:
+    /** \brief Creates an instance of class DrivenEvo.
+      * \param ham The Hamiltonian, split with SparseOp::construct_parts().
+      * \param te The propagator, created on ham.HamMat.
+      * \param V Interaction strength.
+      * \param t Static hopping amplitude.
+      * \param h Static strength of the quasi-periodic potential.
+      * \param t_amp Amplitude of the drive of the hopping.
+      * \param h_amp Amplitude of the drive of the potential.
+      * \param omega Angular frequency of the drive.
+      * \param resolution Largest step, as a fraction of the period.
+      */
+    DrivenEvo(SparseOp &ham,
+              KrylovEvo &te,
+              double V,
+              double t,
+              double h,
+              double t_amp,
+              double h_amp,
+              double omega,
+              PetscInt resolution);
+    /** \brief Time evolution routine.
+      * \param final_time Final time value.
+      * \param initial_time Initial time value.
+      * \param vec A vector that represents the initial state at time = initial_time.
+      *
+      * The interval is split into steps of equal length, no longer than the period over the
+      * resolution. The state is replaced with its time-evolved counterpart.
+      */
+    void driven_evo(const double &final_time,
+                    const double &initial_time,
+                    Vec &vec);
+
+  private:
+    SparseOp &ham_; ///< The Hamiltonian, its coefficients are changed at every exponential.
+    KrylovEvo &te_; ///< The propagator.
+    double V_; ///< Interaction strength.
+    double t_; ///< Static hopping amplitude.
+    double h_; ///< Static strength of the potential.
+    double t_amp_; ///< Amplitude of the drive of the hopping.
+    double h_amp_; ///< Amplitude of the drive of the potential.
+    double omega_; ///< Angular frequency of the drive.
+    PetscInt resolution_; ///< Steps per period.
+    /// Applies exp(i dt (w_1 H(s_1) + w_2 H(s_2))) to vec.
+    void exponential_(double s_1,
+                      double w_1,
+                      double s_2,
+                      double w_2,
+                      double dt,
+                      Vec &vec);
+};
+#endif
+/** @}*/
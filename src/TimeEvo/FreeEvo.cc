@@ -0,0 +1,187 @@
+#include "FreeEvo.h"
+
+#include <boost/math/constants/constants.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <ctime>
+#include <petscblaslapack.h>
+
+#include "../Utils/Utils.h"
+
+/*******************************************************************************/
+// Single custom constructor for this class.
+// Hops towards the next site of the ring. For hard-core bosons the one across
+// the boundary carries the sign of the Jordan-Wigner string through the other
+// n - 1 particles
+/*******************************************************************************/
+FreeEvo::FreeEvo(const Environment &env,
+                 double t,
+                 double h,
+                 double beta)
+{
+  l_ = env.l;
+  n_ = env.n;
+  mpirank_ = env.mpirank;
+  comm_ = env.comm;
+
+  const double pi = boost::math::constants::pi<double>();
+
+  modes_.assign(l_ * l_, 0.0);
+  for(unsigned int site = 0; site < l_; ++site)
+    modes_[site + site * l_] = h * cos(2 * pi * beta * site);
+
+  bool twisted = (env.statistics == Environment::HARDCORE_BOSONS && n_ % 2 == 0);
+  if(l_ > 1){
+    for(unsigned int site = 0; site < l_; ++site){
+      unsigned int next_site = (site + 1) % l_;
+      double hop = (next_site == 0 && twisted) ? -t : t;
+      modes_[site + next_site * l_] += hop;
+      modes_[next_site + site * l_] += hop;
+    }
+  }
+
+  // Every process of the group diagonalises its own copy, the eigenvectors
+  // overwrite the Hamiltonian
+  PetscBLASInt bl, lwork, info;
+  PetscBLASIntCast(l_, &bl);
+  PetscBLASIntCast(std::max(1u, 2 * l_), &lwork);
+  std::vector<PetscScalar> work(lwork);
+  std::vector<PetscReal> rwork(std::max(1u, 3 * l_));
+  energies_.resize(l_);
+  LAPACKheev_("V", "U", &bl, &modes_[0], &bl, &energies_[0], &work[0], &lwork, &rwork[0], &info);
+  if(info != 0){
+    std::cerr << "Diagonalisation of the single-particle Hamiltonian failed, aborting" 
+      << std::endl;
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+}
+
+/*******************************************************************************/
+// Random initial state, chosen on the first process of the group
+/*******************************************************************************/
+void FreeEvo::random_initial_state(bool wtime, 
+                                   bool verbose)
+{
+  boost::random::mt19937 gen;
+
+  if(wtime) gen.seed(static_cast<LLInt>(std::time(0)));
+
+  Occupied.resize(n_);
+
+  if(mpirank_ == 0){
+    LLInt basis_size = Utils::binomial(l_, n_);
+    if(l_ <= STATE_MAX_SITES && basis_size < LLONG_MAX){
+      boost::random::uniform_int_distribution<LLInt> dist(0, basis_size - 1);
+      State state = Utils::unrank_state(dist(gen), l_, n_);
+
+      if(verbose){
+        std::cout << "Initial state randomly chosen: " << state << std::endl;
+        std::cout << "With binary representation: " << std::endl;
+        std::cout << Utils::state_to_binary(state, l_) << std::endl;
+      }
+
+      for(unsigned int site = 0, k = 0; site < l_; ++site)
+        if(Utils::occupied(state, site)) Occupied[k++] = site;
+    }
+    else{
+      // Partial Fisher-Yates shuffle of the sites
+      std::vector<unsigned int> sites(l_);
+      for(unsigned int site = 0; site < l_; ++site) sites[site] = site;
+      for(unsigned int k = 0; k < n_; ++k){
+        boost::random::uniform_int_distribution<unsigned int> dist(k, l_ - 1);
+        std::swap(sites[k], sites[dist(gen)]);
+      }
+      std::copy(sites.begin(), sites.begin() + n_, Occupied.begin());
+      std::sort(Occupied.begin(), Occupied.end());
+
+      if(verbose){
+        std::cout << "Initial state randomly chosen, occupied sites:";
+        for(unsigned int k = 0; k < n_; ++k) std::cout << " " << Occupied[k];
+        std::cout << std::endl;
+      }
+    }
+  }
+
+  if(n_) MPI_Bcast(&Occupied[0], n_, MPI_UNSIGNED, 0, comm_);
+}
+
+/*******************************************************************************/
+// Neel state, a particle on every even site as in Sector::neel(), which is not
+// called since its elements are limited to STATE_MAX_SITES sites
+/*******************************************************************************/
+void FreeEvo::neel_initial_state()
+{
+  if((l_ + 1) / 2 != n_){
+    std::cerr << "Not implemented!" << std::endl;
+    std::cerr << "Neel state has only been implemented for half-filled systems" << std::endl;
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+
+  Occupied.resize(n_);
+  for(unsigned int k = 0; k < n_; ++k) Occupied[k] = 2 * k;
+}
+
+/*******************************************************************************/
+// The return amplitude is the determinant of the propagator restricted to the
+// occupied sites, V_S diag(exp(i E t)) V_S^H. Evaluated from the initial time
+// every call, so there's no accumulation of errors
+/*******************************************************************************/
+double FreeEvo::loschmidt_echo(double time)
+{
+  // Rows of the occupied sites, each one contiguous, and the same rows with
+  // the phases of the modes applied
+  std::vector<PetscScalar> rows(n_ * l_), phased(n_ * l_);
+  for(unsigned int k = 0; k < l_; ++k){
+    PetscScalar phase = PetscExpScalar(PETSC_i * time * energies_[k]);
+    for(unsigned int i = 0; i < n_; ++i){
+      rows[k + i * l_] = modes_[Occupied[i] + k * l_];
+      phased[k + i * l_] = phase * rows[k + i * l_];
+    }
+  }
+
+  std::vector<PetscScalar> sub(n_ * n_);
+  for(unsigned int j = 0; j < n_; ++j){
+    for(unsigned int i = 0; i < n_; ++i){
+      PetscScalar sum = 0.0;
+      for(unsigned int k = 0; k < l_; ++k)
+        sum += phased[k + i * l_] * PetscConj(rows[k + j * l_]);
+      sub[i + j * n_] = sum;
+    }
+  }
+
+  PetscScalar amplitude = determinant_(sub, n_);
+
+  return (PetscRealPart(amplitude) * PetscRealPart(amplitude)) + 
+    (PetscImaginaryPart(amplitude) * PetscImaginaryPart(amplitude));
+}
+
+/*******************************************************************************/
+// Gaussian elimination, the determinant is the product of the pivots
+/*******************************************************************************/
+PetscScalar FreeEvo::determinant_(std::vector<PetscScalar> &a, 
+                                  unsigned int dim)
+{
+  PetscScalar det = 1.0;
+
+  for(unsigned int k = 0; k < dim; ++k){
+    unsigned int pivot = k;
+    for(unsigned int i = k + 1; i < dim; ++i)
+      if(PetscAbsScalar(a[i + k * dim]) > PetscAbsScalar(a[pivot + k * dim])) pivot = i;
+
+    if(PetscAbsScalar(a[pivot + k * dim]) == 0.0) return 0.0;
+
+    if(pivot != k){
+      for(unsigned int j = k; j < dim; ++j) std::swap(a[k + j * dim], a[pivot + j * dim]);
+      det = -det;
+    }
+
+    det *= a[k + k * dim];
+
+    for(unsigned int i = k + 1; i < dim; ++i){
+      PetscScalar factor = a[i + k * dim] / a[k + k * dim];
+      for(unsigned int j = k + 1; j < dim; ++j) a[i + j * dim] -= factor * a[k + j * dim];
+    }
+  }
+
+  return det;
+}
@@ -0,0 +1,76 @@
+/** @addtogroup Core
+ * @{
+ */
+/**
+ * \class FreeEvo.
+ * \ingroup Core
+ * \brief Time evolution of non-interacting particles in the single-particle space.
+ *
+ * For a single particle, or without interaction (V = 0), the dynamics is fully determined by
+ * the L x L single-particle Hamiltonian: hopping t between neighbouring sites of the ring and
+ * on-site potential h cos(2 pi beta i). Through the Jordan-Wigner transformation hard-core
+ * bosons are free fermions, whose hop across the boundary picks up the sign (-1)^(n - 1);
+ * with -statistics fermions the particles are free fermions already and no sign is added.
+ * The Hamiltonian is diagonalised once, H = V diag(E) V^H, and the return amplitude of a basis
+ * element with occupied sites S is the determinant of the propagator U = exp(i t H) restricted
+ * to S (overlap of Slater determinants). That block is V_S diag(exp(i E t)) V_S^H, with V_S the
+ * rows of V of the occupied sites, so every time costs O(L n^2) instead of a dense L x L
+ * exponential. Neither the basis nor the distributed Hamiltonian are required, so chains of
+ * thousands of sites can be evolved. The eigenvectors are replicated on every process of the
+ * group.
+ */
+#ifndef __FREE_EVO_H
+#define __FREE_EVO_H
+
+#include "../Environment/Environment.h"
+#include "../Log/Log.h"
+
+class FreeEvo
+{
+  public:
+    /** \brief Creates an instance of class FreeEvo.
+      * \param env The environment.
+      * \param t Hopping amplitude.
+      * \param h Strength of the quasi-periodic potential.
+      * \param beta Frequency of the quasi-periodic potential.
+      *
+      * Builds the single-particle Hamiltonian for the number of particles of env and diagonalises
+      * it with LAPACK.
+      */
+    FreeEvo(const Environment &env,
+            double t,
+            double h,
+            double beta);
+    /** \brief Picks a random basis element as initial state.
+      * \param wtime If true, random state changes with each execution based on current time.
+      * \param verbose Prints the chosen state.
+      *
+      * The same element as InitialState::random_initial_state() is chosen while the basis can be 
+      * represented (its dimension fits in a 64-bit integer), otherwise n distinct sites are drawn.
+      */
+    void random_initial_state(bool wtime = false,
+                              bool verbose = false);
+    /// Neel initial state, a particle on every even site as in Sector::neel(), so n = (l + 1) / 2.
+    void neel_initial_state();
+    /** \brief Loschmidt echo of the initial state.
+      * \param time Elapsed time.
+      * \return Squared modulus of the return amplitude after the given time.
+      */
+    double loschmidt_echo(double time);
+    std::vector<unsigned int> Occupied; ///< Occupied sites of the initial state.
+  private:
+    unsigned int l_; ///< Number of sites.
+    unsigned int n_; ///< Subspace descriptor.
+    PetscMPIInt mpirank_; ///< Index of the local processor.
+    MPI_Comm comm_; ///< Communicator of the group of the process.
+    std::vector<PetscReal> energies_; ///< Eigenvalues of the single-particle Hamiltonian.
+    std::vector<PetscScalar> modes_; ///< Eigenvectors of the single-particle Hamiltonian (columns).
+    /** \brief Determinant of a dense matrix, by LU decomposition with partial pivoting.
+      * \param a Column-major matrix, overwritten.
+      * \param dim Dimension of the matrix.
+      */
+    PetscScalar determinant_(std::vector<PetscScalar> &a, 
+                             unsigned int dim);
+};
+#endif
+/** @}*/
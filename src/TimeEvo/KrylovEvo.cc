@@ -0,0 +1,204 @@
+#include "KrylovEvo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <boost/math/special_functions/bessel.hpp>
+
+KrylovEvo::KrylovEvo(const Mat &ham_mat,
+                     const double &tol,
+                     const int &max_kryt_its,
+                     Method method)
+{
+  method_ = method;
+  ham_mat_ = ham_mat;
+  tol_ = tol;
+  max_its_ = max_kryt_its;
+  substeps_ = 1;
+  tune_next_ = 0;
+  tune_best_ = 0;
+  tune_best_cost_ = 0.0;
+  tune_verbose_ = false;
+  reason = MFN_CONVERGED_ITERATING;
+
+  // The solver lives in the same communicator as the operator
+  PetscObjectGetComm((PetscObject) ham_mat, &comm_);
+
+  if(method_ == METHOD_CHEBYSHEV){
+    // Three work vectors with the layout of the matrix, and no Krylov basis
+    MatCreateVecs(ham_mat_, &prev_, &cur_);
+    VecDuplicate(cur_, &work_);
+
+    Log::stage_push(Log::STAGE_TIME_EVO);
+    Log::event_begin(Log::EVENT_BOUNDS);
+    PetscReal e_min, e_max;
+    Utils::spectral_bounds(ham_mat_, 0.01, e_min, e_max);
+    scale_ = 0.5 * (e_max - e_min);
+    shift_ = 0.5 * (e_max + e_min);
+    Log::event_end(Log::EVENT_BOUNDS);
+    Log::stage_pop();
+    return;
+  }
+
+  MFNCreate(comm_, &mfn_);
+  MFNSetOperator(mfn_, ham_mat);
+  MFNGetFN(mfn_, &f_);
+  FNSetType(f_, FNEXP);
+  MFNSetTolerances(mfn_, tol, max_kryt_its);
+
+  MFNSetType(mfn_, MFNEXPOKIT);
+  MFNSetUp(mfn_);
+}
+
+KrylovEvo::~KrylovEvo()
+{
+  if(method_ == METHOD_CHEBYSHEV){
+    VecDestroy(&prev_);
+    VecDestroy(&cur_);
+    VecDestroy(&work_);
+  }
+  else{
+    MFNDestroy(&mfn_);
+  }
+}
+
+/*******************************************************************************/
+// While tuning, the combination of this call is set first and its time,
+// taken by the slowest process, is compared with the best one so far
+/*******************************************************************************/
+void KrylovEvo::krylov_evo(const double &final_time,
+                           const double &initial_time,
+                           Vec &vec)
+{
+  bool tuning = tune_next_ < tune_dims_.size();
+  if(tuning) set_dimensions(tune_dims_[tune_next_], tune_substeps_[tune_next_]);
+
+  Log::stage_push(Log::STAGE_TIME_EVO);
+  Log::event_begin(Log::EVENT_KRYLOV);
+
+  double start = MPI_Wtime();
+  double dt = (final_time - initial_time) / substeps_;
+  for(PetscInt k = 0; k < substeps_ && reason >= 0; ++k){
+    if(method_ == METHOD_CHEBYSHEV) chebyshev_evo_(dt, vec);
+    else expokit_evo_(dt, vec);
+  }
+  double elapsed = MPI_Wtime() - start;
+
+  Log::event_end(Log::EVENT_KRYLOV);
+  Log::stage_pop();
+
+  if(reason < 0){
+    std::cerr << "Krylov solver did not converge, aborting" << std::endl;
+    std::cerr << "Change tolerance or maximum number of iterations" << std::endl;
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+
+  if(tuning){
+    MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, comm_);
+    double cost = elapsed / std::max(std::abs(final_time - initial_time), 1.0e-300);
+    if(tune_next_ == 0 || cost < tune_best_cost_){
+      tune_best_ = tune_next_;
+      tune_best_cost_ = cost;
+    }
+    if(++tune_next_ == tune_dims_.size()){
+      set_dimensions(tune_dims_[tune_best_], tune_substeps_[tune_best_]);
+
+      PetscMPIInt rank;
+      MPI_Comm_rank(comm_, &rank);
+      if(tune_verbose_ && rank == 0){
+        std::cout << "Autotuned propagator: ";
+        if(method_ == METHOD_EXPOKIT) std::cout << "Krylov dimension " << tune_dims_[tune_best_] << ", ";
+        std::cout << substeps_ << " substep(s) per step, " << tune_best_cost_
+          << " s per unit of time" << std::endl;
+      }
+    }
+  }
+}
+
+void KrylovEvo::set_dimensions(PetscInt krylov_dim, PetscInt substeps)
+{
+  substeps_ = std::max(substeps, static_cast<PetscInt> (1));
+
+  // A new dimension reallocates the Krylov basis, outside the timed steps
+  if(method_ == METHOD_EXPOKIT && krylov_dim > 0){
+    MFNSetDimensions(mfn_, krylov_dim);
+    MFNSetUp(mfn_);
+  }
+}
+
+void KrylovEvo::autotune(const std::vector<PetscInt> &dims,
+                         const std::vector<PetscInt> &substeps,
+                         bool verbose)
+{
+  tune_dims_.clear();
+  tune_substeps_.clear();
+  tune_next_ = 0;
+  tune_verbose_ = verbose;
+
+  // The dimension has no meaning for the Chebyshev expansion
+  std::vector<PetscInt> candidates(dims);
+  if(method_ == METHOD_CHEBYSHEV || candidates.empty()) candidates.assign(1, 0);
+
+  for(std::size_t i = 0; i < candidates.size(); ++i){
+    for(std::size_t j = 0; j < substeps.size(); ++j){
+      tune_dims_.push_back(candidates[i]);
+      tune_substeps_.push_back(substeps[j]);
+    }
+  }
+}
+
+void KrylovEvo::expokit_evo_(double dt, Vec &vec)
+{
+  FNSetScale(f_, dt * PETSC_i, 1.0);
+  MFNSolve(mfn_, vec, vec);
+
+  PetscInt its;
+  MFNGetIterationNumber(mfn_, &its);
+  Log::count(Log::COUNTER_KRYLOV_ITS, its);
+
+  MFNGetConvergedReason(mfn_, &reason);
+}
+
+/*******************************************************************************/
+// The coefficients are known before the recursion starts: the series is cut
+// once the Bessel functions, beyond their turning point at k = z, fall below
+// the tolerance. The phase exp(i shift dt) is included in the coefficients
+/*******************************************************************************/
+void KrylovEvo::chebyshev_evo_(double dt, Vec &vec)
+{
+  double z = scale_ * dt;
+  PetscScalar phase = std::cos(shift_ * dt) + PETSC_i * std::sin(shift_ * dt);
+
+  std::vector<PetscScalar> coeffs;
+  PetscScalar ik = 1.0;
+  for(PetscInt k = 0; ; ++k){
+    double bessel = boost::math::cyl_bessel_j(static_cast<double> (k), z);
+    if(k > std::abs(z) && 2.0 * std::abs(bessel) < tol_) break;
+    if(k > max_its_){
+      reason = MFN_DIVERGED_ITS;
+      return;
+    }
+    coeffs.push_back(((k == 0) ? 1.0 : 2.0) * ik * bessel * phase);
+    ik *= PETSC_i;
+  }
+
+  // cur_ holds T_k |vec> and prev_ holds T_k-1 |vec>, vec accumulates the series
+  VecCopy(vec, cur_);
+  VecScale(vec, coeffs[0]);
+  for(std::size_t k = 1; k < coeffs.size(); ++k){
+    MatMult(ham_mat_, cur_, work_);
+    if(k == 1){
+      VecWAXPY(prev_, -shift_, cur_, work_);
+      VecScale(prev_, 1.0 / scale_);
+    }
+    else{
+      VecAXPBYPCZ(prev_, 2.0 / scale_, -2.0 * shift_ / scale_, -1.0, work_, cur_);
+    }
+    std::swap(prev_, cur_);
+    VecAXPY(vec, coeffs[k], cur_);
+  }
+
+  Log::count(Log::COUNTER_KRYLOV_ITS, coeffs.size() - 1);
+  reason = MFN_CONVERGED_TOL;
+}
@@ -0,0 +1,129 @@
+/** @addtogroup Core
+ * @{
+ */
+/**
+ * \class KrylovEvo.
+ * \ingroup Core
+ * \brief This class is used to evaluate the dynamics of the system using the Krylov approach.
+ *
+ * The method used to evaluate the action of the propagator is described in Section 2 and Section 3
+ * (Time evolution) of the manuscript in /docs. The Krylov subspace method applied in this approach
+ * is the Arnoldi method in conjuction with irreducible Pade approximations (Figure 1 of the manuscript).
+ * The method used in this implementation is the one implemented in SLEPc as part of the MFN section,
+ * which is the same method described by R. Sidje (https://www.maths.uq.edu.au/expokit/)
+ * For more information refer to the manuscript in /docs and the SLEPc manual: 
+ * http://slepc.upv.es/documentation/
+ *
+ * Alternatively (-evo_method chebyshev) the propagator is expanded in Chebyshev polynomials of
+ * the Hamiltonian rescaled into [-1, 1] with its spectral bounds,
+ * exp(i H dt) = exp(i shift dt) [J_0(z) + 2 sum_k i^k J_k(z) T_k(x)], with z = scale dt and
+ * J_k the Bessel functions, which decay faster than exponentially for k > z. The polynomials
+ * are applied by their three-term recursion, which needs only MatMult, three work vectors and
+ * no inner products, i.e. no global reductions. The cost of a step grows linearly with its
+ * length, so this method pays off for long steps on many processes, where the reductions of
+ * the Arnoldi iteration limit the scaling.
+ *
+ * Every call of krylov_evo() can be split into substeps of equal length. The best Krylov
+ * dimension and number of substeps depend on the size of the system, the number of processes
+ * and the time step, so they can be autotuned: the first calls try one combination each,
+ * timed per unit of simulated time, and the fastest one is kept for the rest of the trajectory.
+ * The tuning calls evolve the state as usual, no work is wasted.
+ */
+#ifndef __KRYLOV_EVO_H
+#define __KRYLOV_EVO_H
+
+#include <vector>
+
+#include "../Environment/Environment.h"
+#include "../Basis/Basis.h"
+#include "../Log/Log.h"
+#include "../Utils/Utils.h"
+
+class KrylovEvo
+{
+  public:
+    /// Methods to evaluate the action of the propagator.
+    enum Method { METHOD_EXPOKIT, METHOD_CHEBYSHEV };
+    /** \brief Creates an instance of class KrylovEvo.
+      * \param ham_mat The Hamiltonian matrix, or any other matrix object from PETSc.
+      * \param tol Tolerance of the algorithm.
+      * \param max_kryt_its Maximum amount of iterations of the algorithm, for the Chebyshev
+      *                     expansion the number of terms of a single step.
+      * \param method Method of the propagator.
+      *
+      * This is the only available constructor of this class. After creating an instance of this class
+      * the MFN and FN environments are set with the parameters given, or the spectral bounds of the
+      * Chebyshev expansion are estimated (see Utils::spectral_bounds()).
+      */
+    KrylovEvo(const Mat &ham_mat,
+              const double &tol,
+              const int &max_kryt_its,
+              Method method = METHOD_EXPOKIT);
+    /** \brief Destructor.
+      * 
+      * Deallocates and destroys objects associated with the MFN component of SLEPc, or the work
+      * vectors of the Chebyshev expansion.
+      */ 
+    ~KrylovEvo();
+    MFNConvergedReason reason; ///< Object related to the convergence of the algorithm.
+                               ///< If !=0, then the algorithm failed to converge with given parameters.
+    /** \brief Time evolution routine.
+      * \param final_time Final time value.
+      * \param initial_time Initial time value.
+      * \param vec A vector that represents the initial state at time = initial_time.
+      *
+      * This method is used to evolve in time a given state. The state is replaced with it's time-evolved
+      * counterpart.
+      */ 
+    void krylov_evo(const double &final_time,
+                    const double &initial_time,
+                    Vec &vec);
+    /** \brief Sets the Krylov dimension and the splitting of the time steps.
+      * \param krylov_dim Dimension of the Krylov subspace (MFNSetDimensions()), ignored if not
+      *                   positive and by the Chebyshev expansion.
+      * \param substeps Number of substeps of equal length of every call of krylov_evo().
+      */
+    void set_dimensions(PetscInt krylov_dim,
+                        PetscInt substeps);
+    /** \brief Autotunes the Krylov dimension and the splitting of the time steps.
+      * \param dims Candidate Krylov dimensions, not used by the Chebyshev expansion.
+      * \param substeps Candidate numbers of substeps.
+      * \param verbose Prints the choice.
+      *
+      * Each of the next calls of krylov_evo() uses one of the combinations and is timed (slowest
+      * process). After the last one the fastest per unit of simulated time is set.
+      */
+    void autotune(const std::vector<PetscInt> &dims,
+                  const std::vector<PetscInt> &substeps,
+                  bool verbose);
+  
+  private:
+    Method method_; ///< Method of the propagator.
+    Mat ham_mat_; ///< The Hamiltonian matrix, not owned.
+    MPI_Comm comm_; ///< Communicator of the matrix.
+    PetscInt substeps_; ///< Substeps of every call of krylov_evo().
+    std::vector<PetscInt> tune_dims_; ///< Krylov dimension of every combination being tuned.
+    std::vector<PetscInt> tune_substeps_; ///< Substeps of every combination being tuned.
+    std::size_t tune_next_; ///< Next combination to be timed, tuning is over once all are.
+    std::size_t tune_best_; ///< Fastest combination so far.
+    double tune_best_cost_; ///< Wall time per unit of simulated time of the fastest combination.
+    bool tune_verbose_; ///< Prints the choice.
+    PetscReal tol_; ///< Truncation error of the Chebyshev expansion.
+    PetscInt max_its_; ///< Largest number of terms of the Chebyshev expansion.
+    PetscReal scale_; ///< Half width of the rescaled spectrum, H = scale_ x + shift_.
+    PetscReal shift_; ///< Centre of the spectrum.
+    Vec prev_; ///< Previous vector of the Chebyshev recursion.
+    Vec cur_; ///< Current vector of the Chebyshev recursion.
+    Vec work_; ///< Product of the matrix with the current vector.
+    MFN mfn_; ///< MFN component object, containing details related to parameters of the algorithm.
+    FN f_; ///< FN component object, containing details related to the function to be applied to the
+           ///< operator, exponential in this particular case.
+    /// Replaces vec with exp(i H dt) vec, by SLEPc's MFN.
+    void expokit_evo_(double dt,
+                      Vec &vec);
+    /// Replaces vec with exp(i H dt) vec, by the Chebyshev expansion.
+    void chebyshev_evo_(double dt,
+                        Vec &vec);
+};
+#endif
+/** @}*/
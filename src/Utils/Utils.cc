@@ -0,0 +1,361 @@
+#include "Utils.h"
+
+namespace Utils
+{
+  /*******************************************************************************/
+  // A single division: the remainder of % takes the sign of a, and is moved
+  // into the range of b when both signs differ
+  /*******************************************************************************/
+  LLInt mod(LLInt a, LLInt b)
+  {
+    LLInt r = a % b;
+    return (r != 0 && ((r < 0) != (b < 0))) ? r + b : r;
+  }
+
+  /*******************************************************************************/
+  // Only the set bits are visited, a word of the bitset at a time
+  /*******************************************************************************/
+  LLInt binary_to_int(const boost::dynamic_bitset<> &bs, unsigned int l)
+  {
+    LLInt integer = 0;
+
+    for(std::size_t i = bs.find_first(); i < l && i != bs.npos; i = bs.find_next(i))
+      integer |= 1LL << i;
+
+    return integer;
+  }
+
+  boost::dynamic_bitset<> state_to_binary(const State &state, unsigned int l)
+  {
+    boost::dynamic_bitset<> bs(l);
+
+    for(unsigned int i = 0; i < l; ++i)
+      bs[i] = occupied(state, i);
+
+    return bs;
+  }
+
+  /*******************************************************************************/
+  // Binary search: Divide and conquer. For the construction of the Hamiltonian
+  // matrix instead of looking through all the elements of the int basis a
+  // binary search will perform better for large systems. The range is halved
+  // without an early exit, so the loop has a fixed trip count for a given
+  // length and its only branch, the choice of half, compiles to a conditional
+  // move for single word elements. Equality is checked once at the end
+  /*******************************************************************************/
+  LLInt binsearch(const State *array, LLInt len, const State &value)
+  {
+    if(len == 0) return -1;
+
+    const State *base = array;
+    while(len > 1){
+      LLInt half = len / 2;
+      base = (value < base[half]) ? base : base + half;
+      len -= half;
+    }
+
+    return (*base == value) ? base - array : -1;
+  }
+
+  void sorted_search(const State *array, LLInt len, const State *values, LLInt n_values,
+                     LLInt *indices)
+  {
+    const State *lo = array;
+    const State *hi = array + len;
+
+    for(LLInt i = 0; i < n_values; ++i){
+      lo = std::lower_bound(lo, hi, values[i]);
+      if(lo != hi && *lo == values[i])
+        indices[i] = lo - array;
+      else
+        indices[i] = -1;
+    }
+  }
+
+  /*******************************************************************************/
+  // The same missing element is normally requested by several states, only the
+  // unique set is communicated and searched for. cont keeps the link to the 
+  // requesting states through its position in the table
+  /*******************************************************************************/
+  void build_request_table(const std::vector<State> &missing, std::vector<State> &requests,
+                           std::vector<LLInt> &cont)
+  {
+    requests = missing;
+    std::sort(requests.begin(), requests.end());
+    requests.erase(std::unique(requests.begin(), requests.end()), requests.end());
+
+    cont.resize(missing.size());
+    for(ULLInt i = 0; i < missing.size(); ++i)
+      cont[i] = std::lower_bound(requests.begin(), requests.end(), missing[i]) - requests.begin();
+  }
+
+  void expand_request_table(std::vector<LLInt> &cont, const std::vector<LLInt> &requests)
+  {
+    for(ULLInt i = 0; i < cont.size(); ++i)
+      cont[i] = requests[cont[i]];
+  }
+
+  LLInt binomial(LLInt n, LLInt k)
+  {
+    if(k < 0 || k > n) return 0;
+    if(k > n - k) k = n - k;
+
+    ULLInt c = 1;
+    for(LLInt i = 1; i <= k; ++i){
+      ULLInt f = n - k + i;
+      if(c > (ULLInt)LLONG_MAX / f) return LLONG_MAX;
+      c = (c * f) / i;
+    }
+
+    return c;
+  }
+
+#if STATE_WORDS == 1
+  State next_state(const State &state)
+  {
+    LLInt t = (state | (state - 1)) + 1;
+    return t | ((((t & -t) / (state & -state)) >> 1) - 1);
+  }
+#else
+  /*******************************************************************************/
+  // Same permutation as Gosper's hack, site by site: the lowest block of occupied
+  // sites loses its top particle to the next empty site and the rest of the
+  // block moves down to the first sites
+  /*******************************************************************************/
+  State next_state(const State &state)
+  {
+    unsigned int low = 0;
+    while(!occupied(state, low)) ++low;
+    unsigned int high = low;
+    while(occupied(state, high + 1)) ++high;
+
+    State next = hop(state, high, high + 1);
+    for(unsigned int site = low; site < high; ++site) flip(next, site);
+    for(unsigned int site = 0; site < high - low; ++site) flip(next, site);
+
+    return next;
+  }
+#endif
+
+  /*******************************************************************************/
+  // Lexicographic order of the integers with n set bits is the colexicographic
+  // order of the combinations, so the k-th set bit is located at the largest 
+  // position p such that binomial(p, k) does not exceed the remaining index
+  /*******************************************************************************/
+  State unrank_state(LLInt index, unsigned int l, unsigned int n)
+  {
+    State state = State();
+    LLInt pos = l;
+
+    for(LLInt k = n; k > 0; --k){
+      do{
+        --pos;
+      } while(binomial(pos, k) > index);
+
+      flip(state, pos);
+      index -= binomial(pos, k);
+    }
+
+    return state;
+  }
+
+  /*******************************************************************************/
+  // The k-th occupied site, at position p, contributes binomial(p, k) to the
+  // index, the elements with the same higher sites and a smaller k-th one
+  /*******************************************************************************/
+  LLInt rank_state(const State &state, unsigned int l)
+  {
+    LLInt index = 0;
+    LLInt k = 0;
+
+    for(unsigned int pos = 0; pos < l; ++pos)
+      if(occupied(state, pos)) index += binomial(pos, ++k);
+
+    return index;
+  }
+
+  /*******************************************************************************/
+  // Every pair of neighbouring sites with different occupation gives exactly
+  // one hop, these are counted by comparing the state with its rotation
+  /*******************************************************************************/
+#if STATE_WORDS == 1
+  LLInt row_nnz_estimate(const State &state, unsigned int l)
+  {
+    ULLInt mask = (l < 64) ? (1ULL << l) - 1 : ~0ULL;
+    ULLInt s = state;
+    ULLInt rot = ((s >> 1) | (s << (l - 1))) & mask;
+
+    return 1 + __builtin_popcountll((s ^ rot) & mask);
+  }
+#else
+  LLInt row_nnz_estimate(const State &state, unsigned int l)
+  {
+    LLInt nnz = 1;
+
+    for(unsigned int site = 0; site < l; ++site)
+      if(occupied(state, site) != occupied(state, (site + 1) % l)) ++nnz;
+
+    return nnz;
+  }
+#endif
+
+  /*******************************************************************************/
+  // On a ring every particle has two neighbouring sites, each empty with
+  // probability (l - n) / (l - 1), which gives the average number of hops
+  /*******************************************************************************/
+  double predict_memory(Environment::LookupPolicy policy, double b_size, double hops,
+                        PetscMPIInt ranks, PetscInt krylov_dim, bool leader)
+  {
+    double nlocal = std::ceil(b_size / ranks);
+
+    double entry = sizeof(PetscScalar) + sizeof(PetscInt);
+    double index = sizeof(LLInt);
+    double element = sizeof(State);
+
+    // Diagonal and off-diagonal blocks, row pointers and ghost values of MatMult
+    double ghosts = std::min(nlocal * hops, b_size - nlocal);
+    double matrix = nlocal * (1.0 + hops) * entry + 2.0 * (nlocal + 1.0) * index
+      + ghosts * entry;
+
+    // Preallocation arrays, staging buffer and missing states (all hops, worst case). No
+    // element is missing from the shared window
+    double missing = nlocal * hops * (index + element);
+    if(policy == Environment::LOOKUP_WINDOW) missing = 0.0;
+    double transient = 3.0 * nlocal * index + nlocal * hops * index + missing;
+
+    double basis = nlocal * element;
+    if(policy == Environment::LOOKUP_NODE && leader) basis = b_size * element;
+    if(policy == Environment::LOOKUP_RING) basis += nlocal * element;
+    if(policy == Environment::LOOKUP_WINDOW) basis = leader ? b_size * element : 0.0;
+
+    // Krylov basis, initial and work vectors, replicated Hessenberg workspace
+    double krylov = (krylov_dim + 4.0) * nlocal * sizeof(PetscScalar)
+      + 4.0 * (krylov_dim + 2.0) * (krylov_dim + 2.0) * sizeof(PetscScalar);
+
+    return matrix + std::max(basis + transient, krylov);
+  }
+
+  void spectral_bounds(const Mat &mat,
+                       PetscReal margin,
+                       PetscReal &e_min,
+                       PetscReal &e_max)
+  {
+    MPI_Comm comm;
+    PetscObjectGetComm((PetscObject) mat, &comm);
+
+    PetscReal norm;
+    MatNorm(mat, NORM_INFINITY, &norm); // bounds the spectrum in any case
+    e_min = -norm;
+    e_max = norm;
+
+    EPS eps;
+    EPSCreate(comm, &eps);
+    EPSSetOperators(eps, mat, NULL);
+    EPSSetProblemType(eps, EPS_HEP);
+    EPSSetType(eps, EPSKRYLOVSCHUR);
+    EPSSetDimensions(eps, 1, PETSC_DEFAULT, PETSC_DEFAULT);
+    EPSSetTolerances(eps, 1.0e-4, 1000);
+
+    const EPSWhich which[2] = {EPS_SMALLEST_REAL, EPS_LARGEST_REAL};
+    for(int k = 0; k < 2; ++k){
+      EPSSetWhichEigenpairs(eps, which[k]);
+      EPSSolve(eps);
+
+      PetscInt nconv;
+      EPSGetConverged(eps, &nconv);
+      if(nconv > 0){
+        PetscScalar kr, ki;
+        EPSGetEigenvalue(eps, 0, &kr, &ki);
+        if(k == 0) e_min = PetscRealPart(kr);
+        else e_max = PetscRealPart(kr);
+      }
+    }
+
+    EPSDestroy(&eps);
+
+    // A single eigenvalue still needs an interval of finite width
+    PetscReal width = e_max - e_min;
+    if(width <= 0.0) width = std::max(std::abs(e_max), static_cast<PetscReal> (1.0));
+    e_min -= 0.5 * margin * width;
+    e_max += 0.5 * margin * width;
+  }
+
+  void jackson_kernel(PetscInt n_moments,
+                      std::vector<PetscReal> &g)
+  {
+    double q = boost::math::constants::pi<double>() / (n_moments + 1);
+
+    g.resize(n_moments);
+    for(PetscInt n = 0; n < n_moments; ++n)
+      g[n] = ((n_moments - n + 1) * std::cos(q * n) + std::sin(q * n) / std::tan(q))
+        / (n_moments + 1);
+  }
+
+  PetscReal mean_gap_ratio(const std::vector<PetscReal> &energies)
+  {
+    if(energies.size() < 3) return 0.0;
+
+    // Triply degenerate levels have no defined ratio and are skipped
+    PetscReal sum = 0.0;
+    std::size_t count = 0;
+    for(std::size_t k = 0; k + 2 < energies.size(); ++k){
+      PetscReal s0 = energies[k + 1] - energies[k];
+      PetscReal s1 = energies[k + 2] - energies[k + 1];
+      PetscReal larger = std::max(s0, s1);
+      if(larger <= 0.0) continue;
+      sum += std::min(s0, s1) / larger;
+      ++count;
+    }
+
+    return count ? sum / count : 0.0;
+  }
+
+  void philox(const boost::uint32_t counter[4],
+              const boost::uint32_t key[2],
+              boost::uint32_t result[4])
+  {
+    const boost::uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+    const boost::uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+
+    boost::uint32_t c[4] = {counter[0], counter[1], counter[2], counter[3]};
+    boost::uint32_t k[2] = {key[0], key[1]};
+    for(int round = 0; round < 10; ++round){
+      if(round > 0){
+        k[0] += W0;
+        k[1] += W1;
+      }
+      boost::uint64_t p0 = static_cast<boost::uint64_t> (M0) * c[0];
+      boost::uint64_t p1 = static_cast<boost::uint64_t> (M1) * c[2];
+      boost::uint32_t next[4] = {static_cast<boost::uint32_t> (p1 >> 32) ^ c[1] ^ k[0],
+                                 static_cast<boost::uint32_t> (p1),
+                                 static_cast<boost::uint32_t> (p0 >> 32) ^ c[3] ^ k[1],
+                                 static_cast<boost::uint32_t> (p0)};
+      std::copy(next, next + 4, c);
+    }
+
+    std::copy(c, c + 4, result);
+  }
+
+  void random_pair(ULLInt index,
+                   ULLInt stream,
+                   ULLInt seed,
+                   PetscReal &u0,
+                   PetscReal &u1)
+  {
+    const boost::uint32_t counter[4] = {static_cast<boost::uint32_t> (index),
+                                        static_cast<boost::uint32_t> (index >> 32),
+                                        static_cast<boost::uint32_t> (stream),
+                                        static_cast<boost::uint32_t> (stream >> 32)};
+    const boost::uint32_t key[2] = {static_cast<boost::uint32_t> (seed),
+                                    static_cast<boost::uint32_t> (seed >> 32)};
+    boost::uint32_t words[4];
+    philox(counter, key, words);
+
+    // 53 random bits each, shifted by half a unit so that they are never 0 or 1
+    const double unit = 1.0 / 9007199254740992.0;
+    ULLInt bits0 = ((static_cast<ULLInt> (words[0]) << 32) | words[1]) >> 11;
+    ULLInt bits1 = ((static_cast<ULLInt> (words[2]) << 32) | words[3]) >> 11;
+    u0 = (bits0 + 0.5) * unit;
+    u1 = (bits1 + 0.5) * unit;
+  }
+}
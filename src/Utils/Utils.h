@@ -0,0 +1,205 @@
+/** @addtogroup Core
+ * @{
+ */
+/**
+ * \namespace Utils
+ * \ingroup Core
+ * \brief Different utility functions used in the implementation.
+ */
+#ifndef __UTILS_H
+#define __UTILS_H
+
+#include <boost/cstdint.hpp>
+#include <boost/dynamic_bitset.hpp>
+#include <boost/math/constants/constants.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <vector>
+
+#include "../Environment/Environment.h"
+#include "../Basis/Basis.h"
+
+namespace Utils
+{
+  /** \brief A different definition for modulus %, accounts for negative integers.
+    * \param a An integer.
+    * \param b An integer.
+    * \return The modulus of the two integers.
+    */
+  LLInt mod(LLInt a, LLInt b);
+  /** \brief Computes the integer representation of a bitset object.
+    * \param bs The bitset object.
+    * \param l The number of sites in the system.
+    * \return An integer value for the binary representation.
+    */
+  LLInt binary_to_int(const boost::dynamic_bitset<> &bs,
+                      unsigned int l);
+  /** \brief Binary representation of a basis element, for printing.
+    * \param state A basis element.
+    * \param l The number of sites in the system.
+    * \return A bitset object with the occupation of every site.
+    */
+  boost::dynamic_bitset<> state_to_binary(const State &state, 
+                                          unsigned int l);
+  /** \brief Binary search algorithm.
+    * \param array Sorted array of basis elements.
+    * \param len Number of elements in the array.
+    * \param value Element to locate.
+    * \return The index of the found value, -1 if unfound.
+    *
+    * Iterative and branchless, the array must hold unique elements (as the basis does).
+    */
+  LLInt binsearch(const State *array, 
+                  LLInt len, 
+                  const State &value);
+  /** \brief Search of several sorted values in a sorted array.
+    * \param array Sorted array of basis elements.
+    * \param len Number of elements in the array.
+    * \param values Sorted array of elements to locate.
+    * \param n_values Number of values to locate.
+    * \param indices Index of every value in array (-1 if unfound), of size n_values.
+    *
+    * The search range is narrowed after every value, as in a merge-join of both arrays.
+    */
+  void sorted_search(const State *array, 
+                     LLInt len, 
+                     const State *values, 
+                     LLInt n_values, 
+                     LLInt *indices);
+  /** \brief Sorts and removes duplicates of requested basis elements.
+    * \param missing The requested elements.
+    * \param requests The request table, sorted unique elements of missing.
+    * \param cont Position of every requested element in the request table.
+    */
+  void build_request_table(const std::vector<State> &missing, 
+                           std::vector<State> &requests, 
+                           std::vector<LLInt> &cont);
+  /** \brief Inverse operation of build_request_table().
+    * \param cont Positions in the request table, replaced by the corresponding entry of the table.
+    * \param requests The request table, normally holding resolved global indices at this point.
+    */
+  void expand_request_table(std::vector<LLInt> &cont, 
+                            const std::vector<LLInt> &requests);
+  /** \brief Binomial coefficient, saturates instead of overflowing.
+    * \param n An integer.
+    * \param k An integer.
+    * \return The number of combinations of k elements out of n.
+    */
+  LLInt binomial(LLInt n, 
+                 LLInt k);
+  /** \brief Computes the next lexicographic bit permutation (Gosper's hack for a single word).
+    * \param state A basis element.
+    * \return The next larger element with the same number of particles.
+    */
+  State next_state(const State &state);
+  /** \brief Computes the integer representation of a basis element from its global index.
+    * \param index Global index of the element in the lexicographically ordered basis.
+    * \param l The number of sites in the system.
+    * \param n The number of particles in the system.
+    * \return The element.
+    *
+    * Uses the combinatorial number system, so the cost is independent of the index.
+    */
+  State unrank_state(LLInt index, 
+                     unsigned int l, 
+                     unsigned int n);
+  /** \brief Computes the global index of a basis element, inverse of unrank_state().
+    * \param state A basis element.
+    * \param l The number of sites in the system.
+    * \return Global index of the element in the lexicographically ordered basis.
+    */
+  LLInt rank_state(const State &state, 
+                   unsigned int l);
+  /** \brief Estimates the number of non-zero entries of the Hamiltonian row of a basis element.
+    * \param state A basis element.
+    * \param l The number of sites in the system.
+    * \return One diagonal entry plus one entry per occupied/empty pair of neighbouring sites.
+    */
+  LLInt row_nnz_estimate(const State &state, 
+                         unsigned int l);
+  /** \brief Predicts the peak memory of a process, without allocating anything.
+    * \param policy Lookup policy of the basis elements.
+    * \param b_size Dimension of the Hilbert space.
+    * \param hops Average number of hops per element, see Sector::average_hops().
+    * \param ranks Total number of processes.
+    * \param krylov_dim Dimension of the Krylov subspace of the time evolution.
+    * \param leader Whether the process is the first one of its node.
+    * \return Predicted peak, in bytes.
+    *
+    * The peak is the largest of the construction phase (basis, matrix, preallocation
+    * arrays, assembly staging and exchange buffers) and the time evolution phase
+    * (matrix and Krylov basis), with one diagonal and hops off-diagonal entries per row. For
+    * the node policy the leader holds the full basis besides its section, for the shared
+    * window it holds the only copy of the node.
+    */
+  double predict_memory(Environment::LookupPolicy policy, 
+                        double b_size, 
+                        double hops, 
+                        PetscMPIInt ranks, 
+                        PetscInt krylov_dim, 
+                        bool leader);
+  /** \brief Estimates the bounds of the spectrum of a Hermitian matrix.
+    * \param mat The matrix.
+    * \param margin Relative margin added to the bounds, which covers the error of the estimate.
+    * \param e_min Lower bound.
+    * \param e_max Upper bound.
+    *
+    * The extreme eigenvalues are computed with EPS (loose tolerance), the infinity norm of
+    * the matrix is used as bound if they fail to converge. The interval has finite width
+    * also for a single eigenvalue.
+    */
+  void spectral_bounds(const Mat &mat,
+                       PetscReal margin,
+                       PetscReal &e_min,
+                       PetscReal &e_max);
+  /** \brief Jackson kernel of a truncated Chebyshev series.
+    * \param n_moments Number of terms of the series.
+    * \param g Damping factor of every term, g[0] = 1.
+    *
+    * Removes the Gibbs oscillations of the truncated series, a delta function becomes a
+    * Gaussian of width about pi / n_moments in the rescaled spectrum.
+    */
+  void jackson_kernel(PetscInt n_moments,
+                      std::vector<PetscReal> &g);
+  /** \brief Mean ratio of consecutive level spacings.
+    * \param energies Eigenvalues, in increasing order.
+    * \return Mean of min(s_n, s_n+1) / max(s_n, s_n+1), zero for fewer than three distinct levels.
+    *
+    * Needs no unfolding of the spectrum. About 0.386 for Poisson statistics (localised)
+    * and 0.530 for the Gaussian orthogonal ensemble (ergodic).
+    */
+  PetscReal mean_gap_ratio(const std::vector<PetscReal> &energies);
+  /** \brief Philox4x32-10 counter-based random number generator.
+    * \param counter The counter, four 32-bit words.
+    * \param key The key, two 32-bit words.
+    * \param result Four random 32-bit words.
+    *
+    * A bijection of the counter for every key, with ten rounds of multiplications, so
+    * every (counter, key) pair gives independent random numbers without any state to carry.
+    * Agrees with the reference implementation of Random123.
+    */
+  void philox(const boost::uint32_t counter[4],
+              const boost::uint32_t key[2],
+              boost::uint32_t result[4]);
+  /** \brief Two uniform random numbers attached to an index, see philox().
+    * \param index Global index, e.g. of a basis element.
+    * \param stream Independent stream for the same index, e.g. a sample number.
+    * \param seed Seed, the key of the generator.
+    * \param u0 Uniform random number in (0, 1).
+    * \param u1 Uniform random number in (0, 1).
+    *
+    * The numbers only depend on the arguments, so a distributed vector filled by index is
+    * the same for any number of processes, and in any order.
+    */
+  void random_pair(ULLInt index,
+                   ULLInt stream,
+                   ULLInt seed,
+                   PetscReal &u0,
+                   PetscReal &u1);
+}
+#endif
+/** @}*/